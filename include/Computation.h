@@ -7,6 +7,16 @@
 
 namespace abstract {
 
+//
+// Computation class
+//
+// A unit of work producing a value of ComputeType. Computations
+// declare the computations they depend on with depends_on(); source
+// computations (without inputs) are evaluated with compute(), the
+// others with compute(results) receiving the results of their inputs
+// in the order the inputs have been declared. ComputationGraph
+// schedules and memoizes them
+//
 template <typename ComputeType>
 class Computation {
 
@@ -14,11 +24,22 @@ class Computation {
 
         using Compute_t = ComputeType;
 
-        Computation() {}
-        ~Computation() {}
+        Computation() : inputs() {}
+        virtual ~Computation() {}
        
-        virtual ComputeType compute() {}
-        virtual ComputeType compute(const std::vector<ComputeType>&) {}
+        virtual ComputeType compute() { return ComputeType(); }
+        virtual ComputeType compute(const std::vector<ComputeType>&) { return ComputeType(); }
+
+        Computation<ComputeType>& depends_on(Computation<ComputeType>& input) {
+            inputs.push_back(&input);
+            return *this;
+        }
+
+        const std::vector<Computation<ComputeType>*>& get_inputs() const { return inputs; }
+
+    private:
+
+        std::vector<Computation<ComputeType>*> inputs;
 };
 
 }
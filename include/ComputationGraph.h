@@ -0,0 +1,104 @@
+#ifndef ABSTRACT_COMPUTATION_GRAPH_H
+#define ABSTRACT_COMPUTATION_GRAPH_H
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Computation.h"
+#include "Framework.h"
+
+namespace abstract {
+
+//
+// ComputationGraph class
+//
+// Dependency graph of Computation objects (a DAG; the graph does not
+// own the computations). Results of the computations are memoized:
+// evaluate() runs only the computations whose results are out of date,
+// i.e. the ones which have never been run and the ones downstream of a
+// computation marked changed with invalidate().
+//
+// Out of date computations are run level by level in topological
+// order; the computations of a level do not depend on each other and
+// run in parallel on the executor of the graph
+//
+template <typename ComputeType>
+class ComputationGraph : public Framework {
+
+    public:
+
+        using Computation_t = Computation<ComputeType>;
+
+        enum class ImplType {
+            sequential = 0,
+            parallel
+        };
+
+        ComputationGraph()
+            : nodes(), ids(), impl_type(ImplType::sequential), computed_num(0) {}
+        ~ComputationGraph() {}
+
+        // adds the computation along with all its (transitive)
+        // inputs which are not in the graph yet
+        ComputationGraph<ComputeType>& add(Computation_t& computation);
+
+        // the result of the computation is out of date, e.g. its
+        // source data has changed; the computation and everything
+        // downstream of it are recomputed by the next evaluate()
+        ComputationGraph<ComputeType>& invalidate(Computation_t& computation);
+
+        // brings the results of all the computations up to date
+        ComputationGraph<ComputeType>& evaluate();
+
+        // brings the result of the computation up to date, running
+        // only the out of date computations it depends on
+        const ComputeType& evaluate(Computation_t& computation);
+
+        bool is_valid(Computation_t& computation) const { return nodes[id_of(computation)].valid; }
+
+        // last computed result of the computation
+        const ComputeType& result(Computation_t& computation) const { return nodes[id_of(computation)].result; }
+
+        size_t size() const { return nodes.size(); }
+
+        // the number of computations run by the last evaluate()
+        size_t last_computed_num() const { return computed_num; }
+
+        void set_impl_type(ImplType t) { impl_type = t; }
+        ImplType get_impl_type() const { return impl_type; }
+
+    private:
+
+        struct Node {
+            Computation_t* computation;
+            std::vector<int> inputs;
+            std::vector<int> outputs;
+            // 0 for the sources, 1+ the maximum level of the inputs
+            int level;
+            ComputeType result;
+            bool valid;
+        };
+
+        int id_of(Computation_t& computation) const;
+        int add(Computation_t& computation, std::unordered_map<Computation_t*,bool>& visiting);
+
+        // runs the nodes marked in the schedule level by level
+        void run(const std::vector<char>& scheduled);
+
+    private:
+
+        std::vector<Node> nodes;
+        std::unordered_map<Computation_t*,int> ids;
+
+        ImplType impl_type;
+        size_t computed_num;
+};
+
+#include "ComputationGraph.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_COMPUTATION_GRAPH_H
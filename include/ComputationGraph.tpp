@@ -0,0 +1,168 @@
+
+template <typename ComputeType>
+ComputationGraph<ComputeType>& ComputationGraph<ComputeType>::add(Computation_t& computation) {
+    std::unordered_map<Computation_t*,bool> visiting;
+    add(computation, visiting);
+    return *this;
+}
+
+template <typename ComputeType>
+int ComputationGraph<ComputeType>::add(Computation_t& computation, std::unordered_map<Computation_t*,bool>& visiting) {
+
+    auto it = ids.find(&computation);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    if (visiting[&computation]) {
+        std::cerr << "ComputationGraph::add(): error: computations form a dependency cycle";
+        std::exit(EXIT_FAILURE);
+    }
+    visiting[&computation] = true;
+
+    // inputs get smaller ids, so the ids are a topological order
+    std::vector<int> inputs;
+    int level = 0;
+    for (Computation_t* input : computation.get_inputs()) {
+        int input_id = add(*input, visiting);
+        inputs.push_back(input_id);
+        level = std::max(level, nodes[input_id].level+1);
+    }
+
+    int id = nodes.size();
+
+    Node node;
+    node.computation = &computation;
+    node.inputs = inputs;
+    node.level = level;
+    node.result = ComputeType();
+    node.valid = false;
+    nodes.push_back(node);
+
+    for (int input_id : inputs) {
+        nodes[input_id].outputs.push_back(id);
+    }
+
+    ids[&computation] = id;
+    visiting[&computation] = false;
+
+    return id;
+}
+
+template <typename ComputeType>
+int ComputationGraph<ComputeType>::id_of(Computation_t& computation) const {
+    auto it = ids.find(&computation);
+    if (it == ids.end()) {
+        std::cerr << "ComputationGraph: error: the computation has not been added to the graph";
+        std::exit(EXIT_FAILURE);
+    }
+    return it->second;
+}
+
+template <typename ComputeType>
+ComputationGraph<ComputeType>& ComputationGraph<ComputeType>::invalidate(Computation_t& computation) {
+
+    int root = id_of(computation);
+    nodes[root].valid = false;
+
+    // nodes downstream of an invalid node are invalid already
+    std::vector<int> stack(1, root);
+
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+
+        for (int output : nodes[id].outputs) {
+            if (nodes[output].valid) {
+                nodes[output].valid = false;
+                stack.push_back(output);
+            }
+        }
+    }
+
+    return *this;
+}
+
+template <typename ComputeType>
+ComputationGraph<ComputeType>& ComputationGraph<ComputeType>::evaluate() {
+
+    std::vector<char> scheduled(nodes.size(), 0);
+    for (size_t id=0; id<nodes.size(); id++) {
+        scheduled[id] = !nodes[id].valid;
+    }
+
+    run(scheduled);
+
+    return *this;
+}
+
+template <typename ComputeType>
+const ComputeType& ComputationGraph<ComputeType>::evaluate(Computation_t& computation) {
+
+    // out of date nodes the computation depends on; the
+    // inputs of up to date nodes are not needed
+    std::vector<char> scheduled(nodes.size(), 0);
+    std::vector<int> stack(1, id_of(computation));
+
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+
+        if (nodes[id].valid || scheduled[id]) {
+            continue;
+        }
+        scheduled[id] = 1;
+
+        for (int input : nodes[id].inputs) {
+            stack.push_back(input);
+        }
+    }
+
+    run(scheduled);
+
+    return result(computation);
+}
+
+template <typename ComputeType>
+void ComputationGraph<ComputeType>::run(const std::vector<char>& scheduled) {
+
+    // scheduled nodes grouped by their levels
+    std::vector<std::vector<int>> levels;
+    computed_num = 0;
+
+    for (size_t id=0; id<nodes.size(); id++) {
+        if (scheduled[id]) {
+            int level = nodes[id].level;
+            if (level >= static_cast<int>(levels.size())) {
+                levels.resize(level+1);
+            }
+            levels[level].push_back(id);
+            computed_num++;
+        }
+    }
+
+    Executor& executor = this->executor(impl_type == ImplType::parallel);
+
+    for (std::vector<int>& level : levels) {
+        executor.parallel_for(0, level.size(), 1, [&](size_t begin, size_t end) {
+            std::vector<ComputeType> input_rets;
+            for (size_t k=begin; k<end; k++) {
+                Node& node = nodes[level[k]];
+
+                if (node.inputs.empty()) {
+                    node.result = node.computation->compute();
+                } else {
+                    input_rets.clear();
+                    for (int input : node.inputs) {
+                        input_rets.push_back(nodes[input].result);
+                    }
+                    node.result = node.computation->compute(input_rets);
+                }
+
+                node.valid = true;
+            }
+        });
+    }
+}
+
+// end
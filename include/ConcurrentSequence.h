@@ -0,0 +1,102 @@
+#ifndef CONCURRENT_SEQUENCE_H
+#define CONCURRENT_SEQUENCE_H
+
+#include <cstdlib>
+
+#include <new>
+#include <iostream>
+#include <atomic>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include <Collection.h>
+#include "Memory.h"
+
+namespace abstract {
+
+// ConcurrentSequence class
+//
+// Collection supporting lock-free appends from many threads at once,
+// e.g. from inside OpenMP parallel loops. Elements are stored in a
+// segmented array: segment 0 holds the first SegmentSize elements and
+// every next segment doubles the capacity. An append reserves its index
+// with a single atomic increment and installs a missing segment with a
+// compare-and-swap, so existing elements never move.
+//
+// Appended elements are ordered by their reservations. Iteration is
+// stable once all producers have finished (e.g. after the end of the
+// parallel region); it must not run concurrently with appends.
+//
+// The index is reserved before the element is moved into it, so the
+// element type must be nothrow move constructible: a failed move would
+// leave a counted slot without an element
+//
+template <typename ElemType, std::size_t SegmentSize = 32>
+class ConcurrentSequence : public Collection<ElemType> {
+
+    static_assert((SegmentSize & (SegmentSize-1)) == 0 && SegmentSize > 0,
+                  "ConcurrentSequence: segment size must be a power of two");
+    static_assert(std::is_nothrow_move_constructible<ElemType>::value,
+                  "ConcurrentSequence: element type must be nothrow move constructible");
+
+    public:
+
+        ConcurrentSequence();
+        ~ConcurrentSequence();
+
+        ConcurrentSequence(const ConcurrentSequence&) = delete;
+        ConcurrentSequence& operator=(const ConcurrentSequence&) = delete;
+
+        ElemType& operator[](const std::size_t i) { return slot(i); }
+
+        // primitive operations
+        std::size_t size() const { return _size.load(std::memory_order_acquire); }
+
+        bool empty() const { return size() == 0; }
+
+        // thread-safe append
+        void add(ElemType elem);
+
+        // thread-safe append; returns the index of the element
+        std::size_t push_back(ElemType elem);
+
+        ElemType& at(std::size_t i);
+
+        // not thread-safe
+        void clear();
+
+        template<typename MapFunc>
+        void map(MapFunc map_func);
+
+        template<typename OutputStream>
+        void print(OutputStream& out_stream);
+
+    private:
+
+        static const std::size_t max_segments = 64;
+
+        // segment k holds the indices [SegmentSize*2^(k-1), SegmentSize*2^k),
+        // segment 0 holds [0, SegmentSize)
+        static std::size_t segment_of(std::size_t i);
+        static std::size_t segment_begin(std::size_t k) { return (k == 0) ? 0 : (SegmentSize << (k-1)); }
+        static std::size_t segment_size(std::size_t k) { return (k == 0) ? SegmentSize : (SegmentSize << (k-1)); }
+
+        ElemType* segment(std::size_t k);
+
+        ElemType& slot(std::size_t i) {
+            std::size_t k = segment_of(i);
+            return _segments[k].load(std::memory_order_acquire)[i-segment_begin(k)];
+        }
+
+    private:
+
+        std::atomic<std::size_t> _size;
+        std::atomic<ElemType*> _segments[max_segments];
+};
+
+#include "ConcurrentSequence.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef CONCURRENT_SEQUENCE_H
@@ -0,0 +1,116 @@
+
+template <typename ElemType, std::size_t SegmentSize>
+const std::size_t ConcurrentSequence<ElemType,SegmentSize>::max_segments;
+
+template <typename ElemType, std::size_t SegmentSize>
+ConcurrentSequence<ElemType,SegmentSize>::ConcurrentSequence()
+    : _size(0)
+{
+    for (std::size_t k=0; k<max_segments; k++) {
+        _segments[k].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+ConcurrentSequence<ElemType,SegmentSize>::~ConcurrentSequence() {
+    clear();
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+std::size_t ConcurrentSequence<ElemType,SegmentSize>::segment_of(std::size_t i) {
+    std::size_t q = i/SegmentSize;
+    if (q == 0) {
+        return 0;
+    }
+    // floor(log2(q))+1
+    return 8*sizeof(unsigned long long)-__builtin_clzll(q);
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+ElemType* ConcurrentSequence<ElemType,SegmentSize>::segment(std::size_t k) {
+
+    ElemType* seg = _segments[k].load(std::memory_order_acquire);
+
+    if (seg == nullptr) {
+        // racing producers may allocate the same segment,
+        // only one of them gets to install it
+        std::size_t bytes = segment_size(k)*sizeof(ElemType);
+        ElemType* fresh = static_cast<ElemType*>(heap_resource().allocate(bytes, alignof(ElemType)));
+        if (_segments[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            seg = fresh;
+        } else {
+            heap_resource().deallocate(fresh, bytes, alignof(ElemType));
+        }
+    }
+
+    return seg;
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+std::size_t ConcurrentSequence<ElemType,SegmentSize>::push_back(ElemType elem) {
+
+    std::size_t i = _size.fetch_add(1, std::memory_order_acq_rel);
+    std::size_t k = segment_of(i);
+
+    if (k >= max_segments) {
+        std::cerr << "ConcurrentSequence::push_back(): error: capacity exceeded";
+        std::exit(EXIT_FAILURE);
+    }
+
+    ElemType* seg = segment(k);
+    new (seg+(i-segment_begin(k))) ElemType(std::move(elem));
+
+    return i;
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+void ConcurrentSequence<ElemType,SegmentSize>::add(ElemType elem) {
+    push_back(std::move(elem));
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+ElemType& ConcurrentSequence<ElemType,SegmentSize>::at(std::size_t i) {
+    if (i >= size()) {
+        throw std::out_of_range("ConcurrentSequence::at(): index out of range");
+    }
+    return slot(i);
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+void ConcurrentSequence<ElemType,SegmentSize>::clear() {
+
+    std::size_t n = _size.load(std::memory_order_acquire);
+
+    for (std::size_t i=0; i<n; i++) {
+        slot(i).~ElemType();
+    }
+
+    for (std::size_t k=0; k<max_segments; k++) {
+        ElemType* seg = _segments[k].exchange(nullptr, std::memory_order_acq_rel);
+        if (seg != nullptr) {
+            heap_resource().deallocate(seg, segment_size(k)*sizeof(ElemType), alignof(ElemType));
+        }
+    }
+
+    _size.store(0, std::memory_order_release);
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+template <typename MapFunc>
+void ConcurrentSequence<ElemType,SegmentSize>::map(MapFunc map_func) {
+    std::size_t n = size();
+    for (std::size_t i=0; i<n; i++) {
+        slot(i) = map_func(slot(i));
+    }
+}
+
+template <typename ElemType, std::size_t SegmentSize>
+template <typename OutputStream>
+void ConcurrentSequence<ElemType,SegmentSize>::print(OutputStream& out_stream) {
+    std::size_t n = size();
+    for (std::size_t i=0; i<n; i++) {
+        out_stream << slot(i);
+    }
+}
+
+// end
@@ -0,0 +1,223 @@
+#ifndef ABSTRACT_DISTRIBUTED_H
+#define ABSTRACT_DISTRIBUTED_H
+
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <type_traits>
+
+#include <mpi.h>
+
+namespace abstract {
+
+//
+// Serializer class
+//
+// Turns the values exchanged between processes into bytes and back.
+// Trivially copyable types are copied as they are; vectors of them go
+// in a single block. Other types need a specialization providing the
+// same two functions
+//
+template <typename T, typename Enable = void>
+struct Serializer {
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Serializer: a type which is not trivially copyable needs a Serializer specialization");
+
+    static void write(const T& value, std::vector<char>& buffer) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes+sizeof(T));
+    }
+
+    static void read(const char*& pos, T& value) {
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+    }
+};
+
+// a vector of values: their number followed by the values
+template <typename T>
+void serialize(const std::vector<T>& values, std::vector<char>& buffer);
+
+template <typename T>
+void deserialize(const char*& pos, std::vector<T>& values);
+
+// vector<bool> packs its bits and has no data(): one byte per value
+void serialize(const std::vector<bool>& values, std::vector<char>& buffer);
+void deserialize(const char*& pos, std::vector<bool>& values);
+
+template <typename T>
+struct Serializer<std::vector<T>> {
+
+    static void write(const std::vector<T>& values, std::vector<char>& buffer) {
+        serialize(values, buffer);
+    }
+
+    static void read(const char*& pos, std::vector<T>& values) {
+        deserialize(pos, values);
+    }
+};
+
+template <>
+struct Serializer<std::string> {
+
+    static void write(const std::string& value, std::vector<char>& buffer) {
+        Serializer<std::size_t>::write(value.size(), buffer);
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    static void read(const char*& pos, std::string& value) {
+        std::size_t n;
+        Serializer<std::size_t>::read(pos, n);
+        value.assign(pos, n);
+        pos += n;
+    }
+};
+
+//
+// Communicator class
+//
+// the byte buffer exchanges the distributed skeletons are built on;
+// MPI has to be initialized by the application
+//
+class Communicator {
+
+    public:
+
+        Communicator(MPI_Comm comm = MPI_COMM_WORLD);
+
+        int rank() const { return rank_id; }
+        int size() const { return ranks_num; }
+        MPI_Comm get() const { return comm; }
+
+        // the buffers of all the ranks on the root, in rank order
+        // (other ranks get an empty result)
+        std::vector<std::vector<char>> gather(const std::vector<char>& buffer, int root = 0) const;
+
+        // the buffer of the root on all the ranks
+        void broadcast(std::vector<char>& buffer, int root = 0) const;
+
+        void send(const std::vector<char>& buffer, int dest, int tag = 0) const;
+        std::vector<char> recv(int source, int tag = 0) const;
+
+    private:
+
+        static int count(std::size_t bytes);
+
+    private:
+
+        MPI_Comm comm;
+        int rank_id;
+        int ranks_num;
+};
+
+//
+// DistributedFractal class
+//
+// Spreads a balanced Fractal over the processes of a communicator. The
+// fractal is cut at the shallowest depth with at least subtrees_per_rank
+// subtrees per process; every process grows and computes a contiguous
+// range of these subtrees locally (with the executor of the fractal),
+// along with the few elements above the cut. The results of the
+// subtrees are gathered on rank 0, which computes the top levels.
+//
+// The fractal is configured as usual (balanced type, implementation
+// type, executor, memory resource) before it is handed over
+//
+template <typename FractalType>
+class DistributedFractal {
+
+    public:
+
+        using Seed_t = typename FractalType::Seed_t;
+
+        template <typename ComputeType>
+        using ComputeFunction = typename FractalType::template ComputeFunction<ComputeType>;
+
+        DistributedFractal(FractalType& fractal, MPI_Comm comm = MPI_COMM_WORLD);
+
+        void set_subtrees_per_rank(int n) { subtrees_per_rank = (n > 0) ? n : 1; }
+        int get_subtrees_per_rank() const { return subtrees_per_rank; }
+
+        FractalType& grow(int depth);
+        FractalType& grow(int depth, Seed_t seed);
+
+        // the result is returned on rank 0, and on all the
+        // ranks if broadcast is set (ComputeType() otherwise)
+        template <typename ComputeType>
+        ComputeType compute(ComputeFunction<ComputeType>& func, bool broadcast = false);
+
+        int rank() const { return comm.rank(); }
+        int size() const { return comm.size(); }
+
+        FractalType& local() { return fractal; }
+
+    private:
+
+        // assigns the part of the fractal of this rank
+        void partition(int depth);
+
+    private:
+
+        FractalType& fractal;
+        Communicator comm;
+        int subtrees_per_rank;
+};
+
+//
+// DistributedReduce class
+//
+// Spreads a Reduce over the processes of a communicator by index
+// ranges: every process grows and reduces a contiguous block of the
+// elements (keeping their indices in the whole reduction). The partial
+// results are merged in a binomial tree towards rank 0 with
+// ComputeFunction::combine(), which must be associative; the order
+// of the blocks is preserved. The reduction is therefore required to
+// be of the associative combine type, so that the ranks reduce their
+// blocks with the same combine as the merge
+//
+template <typename ReduceType>
+class DistributedReduce {
+
+    public:
+
+        using Seed_t = typename ReduceType::Seed_t;
+
+        template <typename ComputeType>
+        using ComputeFunction = typename ReduceType::template ComputeFunction<ComputeType>;
+
+        DistributedReduce(ReduceType& reduce, MPI_Comm comm = MPI_COMM_WORLD);
+
+        ReduceType& grow(size_t width);
+        ReduceType& grow(size_t width, Seed_t seed);
+
+        // the result is returned on rank 0, and on all the
+        // ranks if broadcast is set (ComputeType() otherwise)
+        template <typename ComputeType>
+        ComputeType compute(ComputeFunction<ComputeType>& func, bool broadcast = false);
+
+        int rank() const { return comm.rank(); }
+        int size() const { return comm.size(); }
+
+        ReduceType& local() { return reduce; }
+
+    private:
+
+        // assigns the block of elements of this rank
+        void partition(size_t width);
+
+    private:
+
+        ReduceType& reduce;
+        Communicator comm;
+        bool has_part;
+};
+
+#include "Distributed.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_DISTRIBUTED_H
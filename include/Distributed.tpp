@@ -0,0 +1,293 @@
+
+template <typename T>
+void serialize_values(const std::vector<T>& values, std::vector<char>& buffer, std::true_type) {
+    const char* bytes = reinterpret_cast<const char*>(values.data());
+    buffer.insert(buffer.end(), bytes, bytes+values.size()*sizeof(T));
+}
+
+template <typename T>
+void serialize_values(const std::vector<T>& values, std::vector<char>& buffer, std::false_type) {
+    for (const T& value : values) {
+        Serializer<T>::write(value, buffer);
+    }
+}
+
+template <typename T>
+void deserialize_values(const char*& pos, std::vector<T>& values, std::true_type) {
+    std::memcpy(values.data(), pos, values.size()*sizeof(T));
+    pos += values.size()*sizeof(T);
+}
+
+template <typename T>
+void deserialize_values(const char*& pos, std::vector<T>& values, std::false_type) {
+    for (T& value : values) {
+        Serializer<T>::read(pos, value);
+    }
+}
+
+template <typename T>
+void serialize(const std::vector<T>& values, std::vector<char>& buffer) {
+    Serializer<std::size_t>::write(values.size(), buffer);
+    serialize_values(values, buffer, std::is_trivially_copyable<T>());
+}
+
+template <typename T>
+void deserialize(const char*& pos, std::vector<T>& values) {
+    std::size_t n;
+    Serializer<std::size_t>::read(pos, n);
+    values.resize(n);
+    deserialize_values(pos, values, std::is_trivially_copyable<T>());
+}
+
+inline void serialize(const std::vector<bool>& values, std::vector<char>& buffer) {
+    Serializer<std::size_t>::write(values.size(), buffer);
+    for (bool value : values) {
+        buffer.push_back(value ? 1 : 0);
+    }
+}
+
+inline void deserialize(const char*& pos, std::vector<bool>& values) {
+    std::size_t n;
+    Serializer<std::size_t>::read(pos, n);
+    values.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        values[i] = (pos[i] != 0);
+    }
+    pos += n;
+}
+
+inline Communicator::Communicator(MPI_Comm comm)
+    : comm(comm), rank_id(0), ranks_num(1)
+{
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        std::cerr << "Communicator::Communicator(): error: MPI has not been initialized";
+        std::exit(EXIT_FAILURE);
+    }
+    MPI_Comm_rank(comm, &rank_id);
+    MPI_Comm_size(comm, &ranks_num);
+}
+
+inline int Communicator::count(std::size_t bytes) {
+    if (bytes > static_cast<std::size_t>(INT_MAX)) {
+        std::cerr << "Communicator: error: cannot exchange buffers of " << bytes << " bytes";
+        std::exit(EXIT_FAILURE);
+    }
+    return static_cast<int>(bytes);
+}
+
+inline std::vector<std::vector<char>> Communicator::gather(const std::vector<char>& buffer, int root) const {
+
+    int bytes = count(buffer.size());
+
+    std::vector<int> counts(ranks_num);
+    MPI_Gather(&bytes, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm);
+
+    std::vector<int> displs(ranks_num, 0);
+    std::vector<char> all;
+
+    if (rank_id == root) {
+        std::size_t total = 0;
+        for (int r = 0; r < ranks_num; r++) {
+            displs[r] = count(total);
+            total += counts[r];
+        }
+        all.resize(total);
+    }
+
+    MPI_Gatherv(buffer.data(), bytes, MPI_BYTE,
+                all.data(), counts.data(), displs.data(), MPI_BYTE, root, comm);
+
+    std::vector<std::vector<char>> buffers;
+    if (rank_id == root) {
+        for (int r = 0; r < ranks_num; r++) {
+            buffers.emplace_back(all.begin()+displs[r], all.begin()+displs[r]+counts[r]);
+        }
+    }
+    return buffers;
+}
+
+inline void Communicator::broadcast(std::vector<char>& buffer, int root) const {
+    int bytes = count(buffer.size());
+    MPI_Bcast(&bytes, 1, MPI_INT, root, comm);
+    buffer.resize(bytes);
+    MPI_Bcast(buffer.data(), bytes, MPI_BYTE, root, comm);
+}
+
+inline void Communicator::send(const std::vector<char>& buffer, int dest, int tag) const {
+    MPI_Send(buffer.data(), count(buffer.size()), MPI_BYTE, dest, tag, comm);
+}
+
+inline std::vector<char> Communicator::recv(int source, int tag) const {
+    MPI_Status status;
+    MPI_Probe(source, tag, comm, &status);
+
+    int bytes = 0;
+    MPI_Get_count(&status, MPI_BYTE, &bytes);
+
+    std::vector<char> buffer(bytes);
+    MPI_Recv(buffer.data(), bytes, MPI_BYTE, source, tag, comm, MPI_STATUS_IGNORE);
+    return buffer;
+}
+
+template <typename FractalType>
+DistributedFractal<FractalType>::DistributedFractal(FractalType& fractal, MPI_Comm comm)
+    : fractal(fractal), comm(comm), subtrees_per_rank(4) {}
+
+template <typename FractalType>
+void DistributedFractal<FractalType>::partition(int depth) {
+
+    if (fractal.get_type() != FractalType::Type::balanced) {
+        std::cerr << "DistributedFractal::grow(): error: only balanced fractals can be distributed";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // the shallowest depth giving every rank enough subtrees
+    // to even out the ranks' shares
+    size_t wanted = static_cast<size_t>(subtrees_per_rank)*size();
+
+    int split_depth = 0;
+    while (split_depth < depth && fractal.depth_elements_num(split_depth) < wanted) {
+        split_depth++;
+    }
+
+    size_t subtrees = fractal.depth_elements_num(split_depth);
+    size_t first = subtrees*rank()/size();
+    size_t last = subtrees*(rank()+1)/size();
+
+    fractal.set_partition(split_depth, first, last);
+}
+
+template <typename FractalType>
+FractalType& DistributedFractal<FractalType>::grow(int depth) {
+    partition(depth);
+    return fractal.grow(depth);
+}
+
+template <typename FractalType>
+FractalType& DistributedFractal<FractalType>::grow(int depth, Seed_t seed) {
+    partition(depth);
+    return fractal.grow(depth, seed);
+}
+
+template <typename FractalType>
+template <typename ComputeType>
+ComputeType DistributedFractal<FractalType>::compute(ComputeFunction<ComputeType>& func, bool broadcast) {
+
+    std::vector<char> buffer;
+    serialize(fractal.compute_part(func), buffer);
+
+    std::vector<std::vector<char>> buffers = comm.gather(buffer);
+
+    ComputeType ret = ComputeType();
+
+    if (rank() == 0) {
+        // the ranks hold consecutive subtrees
+        std::vector<ComputeType> split_rets;
+        std::vector<ComputeType> rank_rets;
+        for (const std::vector<char>& rank_buffer : buffers) {
+            const char* pos = rank_buffer.data();
+            deserialize(pos, rank_rets);
+            split_rets.insert(split_rets.end(), rank_rets.begin(), rank_rets.end());
+        }
+        ret = fractal.compute_top(func, split_rets);
+    }
+
+    if (broadcast) {
+        buffer.clear();
+        if (rank() == 0) {
+            Serializer<ComputeType>::write(ret, buffer);
+        }
+        comm.broadcast(buffer);
+        const char* pos = buffer.data();
+        Serializer<ComputeType>::read(pos, ret);
+    }
+
+    return ret;
+}
+
+template <typename ReduceType>
+DistributedReduce<ReduceType>::DistributedReduce(ReduceType& reduce, MPI_Comm comm)
+    : reduce(reduce), comm(comm), has_part(false) {}
+
+template <typename ReduceType>
+void DistributedReduce<ReduceType>::partition(size_t width) {
+    size_t first = width*rank()/size();
+    size_t last = width*(rank()+1)/size();
+    has_part = (last > first);
+    reduce.set_partition(first, last);
+}
+
+template <typename ReduceType>
+ReduceType& DistributedReduce<ReduceType>::grow(size_t width) {
+    partition(width);
+    return reduce.grow(width);
+}
+
+template <typename ReduceType>
+ReduceType& DistributedReduce<ReduceType>::grow(size_t width, Seed_t seed) {
+    partition(width);
+    return reduce.grow(width, seed);
+}
+
+template <typename ReduceType>
+template <typename ComputeType>
+ComputeType DistributedReduce<ReduceType>::compute(ComputeFunction<ComputeType>& func, bool broadcast) {
+
+    // the final reduction of the general combine type
+    // sees the values of all the elements at once
+    if (reduce.get_combine_type() != ReduceType::CombineType::associative) {
+        std::cerr << "DistributedReduce::compute(): error: only reductions of the associative combine type can be distributed";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // ranks without elements do not contribute
+    // a value, which might not be neutral
+    bool have = has_part;
+    ComputeType partial = ComputeType();
+
+    if (have) {
+        partial = reduce.compute(func);
+    }
+
+    // binomial tree: at every step the ranks at odd multiples of
+    // step hand their partials over to their left neighbours, which
+    // combine them on the right
+    for (int step = 1; step < size(); step *= 2) {
+        if (rank() % (2*step) == step) {
+            std::vector<char> buffer(1, have ? 1 : 0);
+            if (have) {
+                Serializer<ComputeType>::write(partial, buffer);
+            }
+            comm.send(buffer, rank()-step);
+            break;
+        }
+        if (rank()+step < size()) {
+            std::vector<char> buffer = comm.recv(rank()+step);
+            if (buffer[0] != 0) {
+                ComputeType other;
+                const char* pos = buffer.data()+1;
+                Serializer<ComputeType>::read(pos, other);
+                partial = have ? func.combine(partial, other) : other;
+                have = true;
+            }
+        }
+    }
+
+    ComputeType ret = (rank() == 0) ? partial : ComputeType();
+
+    if (broadcast) {
+        std::vector<char> buffer;
+        if (rank() == 0) {
+            Serializer<ComputeType>::write(ret, buffer);
+        }
+        comm.broadcast(buffer);
+        const char* pos = buffer.data();
+        Serializer<ComputeType>::read(pos, ret);
+    }
+
+    return ret;
+}
+
+// end
@@ -0,0 +1,116 @@
+#ifndef ABSTRACT_DIVIDE_AND_CONQUER_H
+#define ABSTRACT_DIVIDE_AND_CONQUER_H
+
+#include <cstdlib>
+#include <iostream>
+#include <array>
+#include <vector>
+#include <limits>
+
+#include "Framework.h"
+
+namespace abstract {
+
+//
+// DivideAndConquer class
+//
+// Recursive problem solving skeleton. A problem is either solved
+// directly (base case) or divided into Arity subproblems, which are
+// solved recursively and whose solutions are combined into the solution
+// of the problem.
+//
+// The parallel implementation solves the subproblems of every division
+// as tasks of one executor invoke() call, nested inside the call of the
+// parent division, so idle threads of the executor steal them; the last
+// subproblem is solved by the dividing thread itself. Below the
+// sequential cutoff (in units of Algorithm::size()) the recursion runs
+// as plain calls without tasks. Subproblems and their solutions live in
+// fixed-size arrays on the stack of the dividing call
+//
+template <typename ProblemType, typename SolutionType, std::size_t Arity = 2>
+class DivideAndConquer : public Framework {
+
+    static_assert(Arity > 0, "DivideAndConquer: arity must be positive");
+
+    public:
+
+        using Problem_t = ProblemType;
+        using Solution_t = SolutionType;
+
+        using Subproblems = std::array<ProblemType,Arity>;
+        using Solutions = std::array<SolutionType,Arity>;
+
+        enum class ImplType {
+            sequential = 0,
+            parallel
+        };
+
+        // Algorithm class
+        //
+        // Users of the DivideAndConquer class template specify their
+        // algorithm by deriving from below class and overriding its
+        // hooks. Hooks are called concurrently for different subproblems
+        // by the parallel implementation
+        //
+        class Algorithm;
+
+        DivideAndConquer()
+            : impl_type(ImplType::sequential), cutoff(1024) {}
+        ~DivideAndConquer() {}
+
+        //
+        // main compute() interface
+        //
+        // solves the problem with the given algorithm; when called
+        // from inside a job of the executor (or an OpenMP parallel
+        // region for the default executor) the tasks are run by the
+        // threads the executor already runs
+        //
+        SolutionType compute(const ProblemType& problem, Algorithm& alg);
+
+        void set_impl_type(ImplType t) { impl_type = t; }
+        ImplType get_impl_type() const { return impl_type; }
+
+        // subproblems not larger than the cutoff are solved sequentially
+        void set_cutoff(std::size_t c) { cutoff = c; }
+        std::size_t get_cutoff() const { return cutoff; }
+
+    private:
+
+        SolutionType solve_sequential(const ProblemType& problem, Algorithm& alg);
+        SolutionType solve_parallel(const ProblemType& problem, Algorithm& alg);
+
+    private:
+
+        ImplType impl_type;
+        std::size_t cutoff;
+};
+
+template <typename ProblemType, typename SolutionType, std::size_t Arity>
+class DivideAndConquer<ProblemType,SolutionType,Arity>::Algorithm {
+
+    public:
+
+        virtual ~Algorithm() {}
+
+        // base case test
+        virtual bool is_base(const ProblemType& problem) = 0;
+        // direct solution of the base case
+        virtual SolutionType solve(const ProblemType& problem) = 0;
+        // split the problem into Arity subproblems
+        virtual Subproblems divide(const ProblemType& problem) = 0;
+        // merge the solutions of the subproblems
+        virtual SolutionType combine(const ProblemType& problem, Solutions& solutions) = 0;
+
+        // problem size compared against the sequential cutoff; problems
+        // are never considered small enough by default
+        virtual std::size_t size(const ProblemType&) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+};
+
+#include "DivideAndConquer.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_DIVIDE_AND_CONQUER_H
@@ -0,0 +1,58 @@
+
+template <typename ProblemType, typename SolutionType, std::size_t Arity>
+SolutionType DivideAndConquer<ProblemType,SolutionType,Arity>::compute(const ProblemType& problem, Algorithm& alg) {
+
+    if (impl_type == ImplType::sequential) {
+        return solve_sequential(problem, alg);
+    }
+
+    return solve_parallel(problem, alg);
+}
+
+template <typename ProblemType, typename SolutionType, std::size_t Arity>
+SolutionType DivideAndConquer<ProblemType,SolutionType,Arity>::solve_sequential(const ProblemType& problem, Algorithm& alg) {
+
+    if (alg.is_base(problem)) {
+        return alg.solve(problem);
+    }
+
+    Subproblems subproblems = alg.divide(problem);
+    Solutions solutions;
+
+    for (std::size_t i=0; i<Arity; i++) {
+        solutions[i] = solve_sequential(subproblems[i], alg);
+    }
+
+    return alg.combine(problem, solutions);
+}
+
+template <typename ProblemType, typename SolutionType, std::size_t Arity>
+SolutionType DivideAndConquer<ProblemType,SolutionType,Arity>::solve_parallel(const ProblemType& problem, Algorithm& alg) {
+
+    if (alg.is_base(problem)) {
+        return alg.solve(problem);
+    }
+
+    if (alg.size(problem) <= cutoff) {
+        return solve_sequential(problem, alg);
+    }
+
+    Subproblems subproblems = alg.divide(problem);
+    Solutions solutions;
+
+    // the executor runs the last task on the dividing thread,
+    // the others are left to be stolen
+    std::vector<Executor::Task> tasks;
+    tasks.reserve(Arity);
+    for (std::size_t i=0; i<Arity; i++) {
+        tasks.push_back([this, &subproblems, &solutions, &alg, i]() {
+            solutions[i] = solve_parallel(subproblems[i], alg);
+        });
+    }
+
+    this->executor(true).invoke(tasks);
+
+    return alg.combine(problem, solutions);
+}
+
+// end
@@ -4,11 +4,14 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <future>
+
+#include "Framework.h"
 
 namespace abstract {
 
 template <typename ElemType, typename SeedType, typename InjectType>
-class Fold {
+class Fold : public Framework {
 
     public:
 
@@ -16,6 +19,17 @@ class Fold {
         using Seed_t = SeedType;
         using Inject_t = InjectType;
 
+        // OPTIMIZATION HINT
+        //
+        // the elements of a seedless fold are independent and grow
+        // in parallel; seeded growth and compute() are chains
+        // through the fold and always run sequentially
+        //
+        enum class ImplType {
+            sequential = 0,
+            parallel
+        };
+
         // ElementInfo class 
         //
         // builds the location information of an element 
@@ -67,13 +81,46 @@ class Fold {
         template<typename ComputeType>
         ComputeType compute(Fold<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
 
+        //
+        // grow_async()/compute_async()
+        //
+        // grow() and compute() started on the executor of the fold,
+        // returning at once with a future of the result; see Fractal.
+        // The fold and the function must outlive the call, and the
+        // fold must not be used until the future is ready
+        //
+        std::future<Fold<ElemType,SeedType,InjectType>&> grow_async(int depth);
+        std::future<Fold<ElemType,SeedType,InjectType>&> grow_async(int depth, SeedType seed);
+
+        template<typename ComputeType>
+        std::future<ComputeType> compute_async(Fold<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
+
+        // memory taken by the elements of the fold
+        MemoryUsage memory_usage() const;
+
+        void set_impl_type(ImplType t) { impl_type = t; }
+        ImplType get_impl_type() const { return impl_type; }
+
         void set_debug(bool flag) { debug = flag; } 
         bool is_debug() { return debug; } 
 
     private:
 
+        // elements are allocated from the memory resource of the fold
+        using ElementPtr = std::unique_ptr<Element,ResourceDeleter<Element,ElemType>>;
+
+        ElementPtr new_element(const ElementInfo& info) {
+            MemoryResource& resource = this->memory_resource();
+            ElementPtr elem(create_object<ElemType>(resource, info), ResourceDeleter<Element,ElemType>(&resource));
+            return elem;
+        }
+
+    private:
+
+        ImplType impl_type;
+
         int depth;
-        std::vector<std::unique_ptr<Element>> elements;
+        std::vector<ElementPtr> elements;
 
         bool debug;
 };
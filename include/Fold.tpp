@@ -1,7 +1,7 @@
 
 template <typename ElemType, typename SeedType, typename InjectType>
 Fold<ElemType,SeedType,InjectType>::Fold()
-    : elements(), depth(-1), debug(false) {}
+    : impl_type(ImplType::sequential), depth(-1), elements(), debug(false) {}
 
 template <typename ElemType, typename SeedType, typename InjectType>
 Fold<ElemType,SeedType,InjectType>::~Fold() {
@@ -24,21 +24,24 @@ template <typename ElemType, typename SeedType, typename InjectType>
 Fold<ElemType,SeedType,InjectType>& Fold<ElemType,SeedType,InjectType>::grow(int depth) {
     this->depth = depth;
     // reserve required space        
-    // elements.resize(depth);
+    size_t first = elements.size();
+    elements.resize(first+depth+1);
     // fill the fold with new elements
-    for (size_t i=0; i<=depth; i++) {
-        // set element's structural info
-        ElementInfo info;
-        info.depth = i;
-        info.level = depth-i;
-        info.index = i;
-        // allocate memory for the element
-        std::unique_ptr<Element> elem(new ElemType(info));
-        // grow custom element part
-        elem->grow();
-        // put the element into the fold 
-        elements.push_back(std::move(elem));
-    }
+    this->executor(impl_type == ImplType::parallel).parallel_for(0, depth+1, 1, [&](size_t begin, size_t end) {
+        for (size_t i=begin; i<end; i++) {
+            // set element's structural info
+            ElementInfo info;
+            info.depth = i;
+            info.level = depth-i;
+            info.index = i;
+            // allocate memory for the element
+            ElementPtr elem = new_element(info);
+            // grow custom element part
+            elem->grow();
+            // put the element into the fold 
+            elements[first+i] = std::move(elem);
+        }
+    });
     // return grown fold
     return (*this);
 }
@@ -57,7 +60,7 @@ Fold<ElemType,SeedType,InjectType>& Fold<ElemType,SeedType,InjectType>::grow(int
         info.level = depth-i;
         info.index = i;
         // allocate memory for the element
-        std::unique_ptr<Element> elem(new ElemType(info));
+        ElementPtr elem = new_element(info);
         // grow custom element part
         elem->grow(next_seed);
         // spawn child seed for the next element
@@ -93,6 +96,23 @@ ComputeType Fold<ElemType,SeedType,InjectType>::compute(Fold<ElemType,SeedType,I
     return ret;
 }
 
+template <typename ElemType, typename SeedType, typename InjectType>
+std::future<Fold<ElemType,SeedType,InjectType>&> Fold<ElemType,SeedType,InjectType>::grow_async(int depth) {
+    return this->run_async([this, depth]() -> Fold<ElemType,SeedType,InjectType>& { return grow(depth); });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+std::future<Fold<ElemType,SeedType,InjectType>&> Fold<ElemType,SeedType,InjectType>::grow_async(int depth, SeedType seed) {
+    return this->run_async([this, depth, seed]() -> Fold<ElemType,SeedType,InjectType>& { return grow(depth, seed); });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+std::future<ComputeType> Fold<ElemType,SeedType,InjectType>::compute_async(Fold<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& compute_func) {
+    ComputeFunction<ComputeType>* func = &compute_func;
+    return this->run_async([this, func]() { return this->template compute<ComputeType>(*func); });
+}
+
 template <typename ElemType, typename SeedType, typename InjectType>
 Fold<ElemType,SeedType,InjectType>& Fold<ElemType,SeedType,InjectType>::inject(const InjectType inject_data) {
     InjectType inj = inject_data;
@@ -102,4 +122,18 @@ Fold<ElemType,SeedType,InjectType>& Fold<ElemType,SeedType,InjectType>::inject(c
     return (*this);
 }
 
+template <typename ElemType, typename SeedType, typename InjectType>
+MemoryUsage Fold<ElemType,SeedType,InjectType>::memory_usage() const {
+    MemoryUsage usage;
+    std::size_t n = elements.size();
+    usage.payload += n*(sizeof(ElemType)-sizeof(Element));
+    usage.structural += n*sizeof(Element);
+    for (const ElementPtr& elem : elements) {
+        // the resource set now may not be the one the element came from
+        usage.add_blocks(*elem.get_deleter().get_resource(), 1, sizeof(ElemType), alignof(ElemType));
+    }
+    usage.add_vector(&MemoryUsage::structural, elements);
+    return usage;
+}
+
 //
@@ -0,0 +1,183 @@
+#ifndef ABSTRACT_FRACTAL_COMPACT_H
+#define ABSTRACT_FRACTAL_COMPACT_H
+
+#include <cstdlib>
+#include <vector>
+#include <iostream>
+#include <omp.h>
+
+#include "Framework.h"
+#include "HeapTree.h"
+
+namespace abstract {
+
+//
+// CompactFractal class
+//
+// Balanced fractal storing nothing but the user payloads. The complete
+// tree is laid out as a heap in one array of ElemType values: the
+// location of an element (depth, level, child id), its parent and its
+// children are derived from its index on demand instead of being kept
+// in every element. ElemType is a plain value type, it does not derive
+// from any element base class; elements are grown by user functions.
+//
+// The seeds the elements are grown from are dropped once their children
+// have been grown, unless the fractal is asked to keep them
+//
+template <typename ElemType, typename SeedType, int Arity>
+class CompactFractal : public Framework {
+
+    static_assert(Arity > 1, "CompactFractal: arity must be greater than 1");
+
+    public:
+
+        using Fractal_t = CompactFractal<ElemType,SeedType,Arity>;
+        using Element_t = ElemType;
+        using Seed_t = SeedType;
+
+        enum class ImplType {
+            sequential = 0,
+            parallel
+        };
+
+        // location of an element within the fractal,
+        // computed from the element index
+        struct ElementInfo {
+            int depth;
+            int level;
+            int child_id; // [0 .. Arity-1]
+            std::size_t index;
+            static const int children_num = Arity;
+        };
+
+        // ComputeFunction class
+        //
+        // same interface as the compute functions of the dynamic
+        // Fractal, applied to the payloads
+        //
+        template <typename ComputeType>
+        class ComputeFunction {
+            public:
+                using Compute_t = ComputeType;
+
+                virtual ~ComputeFunction() {}
+                virtual Compute_t operator()(ElemType& element,
+                                             const std::vector<Compute_t>& child_rets) = 0;
+        };
+
+        CompactFractal();
+        ~CompactFractal() {}
+
+        void set_impl_type(ImplType t) { impl_type = t; }
+        ImplType get_impl_type() const { return impl_type; }
+
+        // keep the seed of every element after the growth
+        // (off by default)
+        void set_keep_seeds(bool keep) { keep_seeds = keep; }
+        bool get_keep_seeds() const { return keep_seeds; }
+
+        // grow_func(ElemType& element, const ElementInfo& info)
+        //
+        // the parallel implementation calls grow_func concurrently
+        // for the elements of a depth
+        template <typename GrowFunc>
+        Fractal_t& grow(int depth, GrowFunc grow_func);
+
+        // grow_func(ElemType& element, const ElementInfo& info, const SeedType& seed)
+        // spawn_func(const ElemType& parent, const SeedType& parent_seed, int child_id) -> SeedType
+        //
+        // the parent is grown before the seeds of its children are spawned
+        template <typename GrowFunc, typename SpawnFunc>
+        Fractal_t& grow(int depth, SeedType seed, GrowFunc grow_func, SpawnFunc spawn_func);
+
+        template <typename ComputeType>
+        ComputeType compute(ComputeFunction<ComputeType>& func);
+
+        // memory taken by the payloads, the kept seeds and the layout
+        MemoryUsage memory_usage() const {
+            MemoryUsage usage;
+            usage.add_vector(&MemoryUsage::payload, elements);
+            usage.add_vector(&MemoryUsage::structural, seeds);
+            usage.add_vector(&MemoryUsage::structural, depth_start);
+            return usage;
+        }
+
+        // element access
+
+        std::size_t size() const { return elements.size(); }
+        int get_depth() const { return depth; }
+
+        ElemType& element(std::size_t index) { return elements[index]; }
+        const ElemType& element(std::size_t index) const { return elements[index]; }
+
+        ElementInfo element_info(std::size_t index) const {
+            return make_info(index, index_to_depth(index));
+        }
+
+        // the seed the element has been grown from;
+        // available if the seeds are kept
+        const SeedType& get_seed(std::size_t index) const;
+
+        bool has_children(std::size_t index) const {
+            return index < depth_start[depth];
+        }
+
+        bool has_parent(std::size_t index) const { return index > 0; }
+
+        std::size_t parent_index(std::size_t index) const { return (index-1)/Arity; }
+
+        // child_id in [0 .. Arity-1]
+        std::size_t child_index(std::size_t index, int child_id) const { return Arity*index+child_id+1; }
+
+        std::size_t depth_start_index(int d) const { return depth_start[d]; }
+        std::size_t depth_end_index(int d) const { return depth_start[d+1]-1; }
+
+        int index_to_depth(std::size_t index) const {
+            int d = 0;
+            while (index >= depth_start[d+1]) {
+                d++;
+            }
+            return d;
+        }
+
+    private:
+
+        // sets up the layout of a fractal of the given depth
+        void plan(int depth);
+
+        ElementInfo make_info(std::size_t index, int d) const {
+            ElementInfo info;
+            info.depth = d;
+            info.level = top_level-d;
+            info.child_id = (index > 0) ? static_cast<int>((index-1)%Arity) : 0;
+            info.index = index;
+            return info;
+        }
+
+    private:
+
+        ImplType impl_type;
+        bool keep_seeds;
+
+        // fractal parameters
+        // will be set after the grow()
+        // method has been called
+        int depth;
+        int top_level;
+
+        // payloads laid out as a heap
+        std::vector<ElemType> elements;
+
+        // seeds of the elements (if kept)
+        std::vector<SeedType> seeds;
+
+        // index of the first element of every depth;
+        // depth_start[depth+1] is the number of elements
+        std::vector<std::size_t> depth_start;
+};
+
+#include "Fractal_compact.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_FRACTAL_COMPACT_H
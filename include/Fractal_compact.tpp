@@ -0,0 +1,136 @@
+
+template <typename ElemType, typename SeedType, int Arity>
+CompactFractal<ElemType,SeedType,Arity>::CompactFractal()
+    : impl_type(ImplType::sequential), keep_seeds(false),
+      depth(-1), top_level(-1), elements(), seeds(), depth_start() {}
+
+template <typename ElemType, typename SeedType, int Arity>
+void CompactFractal<ElemType,SeedType,Arity>::plan(int depth) {
+
+    if (depth < 0) {
+        std::cerr << "CompactFractal::grow():error: growth depth cannot be negative!";
+        std::exit(EXIT_FAILURE);
+    }
+
+    this->depth = depth;
+    this->top_level = depth+1;
+
+    depth_start.assign(depth+2, 0);
+    for (int d = 0; d <= depth; d++) {
+        depth_start[d+1] = Arity*depth_start[d]+1;
+    }
+
+    elements.clear();
+    elements.resize(depth_start[depth+1]);
+
+    seeds.clear();
+    seeds.shrink_to_fit();
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename GrowFunc>
+CompactFractal<ElemType,SeedType,Arity>& CompactFractal<ElemType,SeedType,Arity>::grow(int depth, GrowFunc grow_func) {
+
+    plan(depth);
+
+    Executor& executor = this->executor(impl_type == ImplType::parallel);
+
+    for (int d = 0; d <= depth; d++) {
+        executor.parallel_for(depth_start[d], depth_start[d+1], 64, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t j = begin; j < end; j++) {
+                grow_func(elements[j], make_info(j, d));
+            }
+        });
+    }
+
+    return *this;
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename GrowFunc, typename SpawnFunc>
+CompactFractal<ElemType,SeedType,Arity>& CompactFractal<ElemType,SeedType,Arity>::grow(int depth, SeedType seed,
+                                                                                      GrowFunc grow_func, SpawnFunc spawn_func) {
+    plan(depth);
+
+    Executor& executor = this->executor(impl_type == ImplType::parallel);
+
+    grow_func(elements[0], make_info(0, 0), seed);
+
+    // OPTIMIZATION
+    //
+    // unless the seeds are kept, only the seeds of the depth being
+    // grown from are alive: the seeds of the leaves are never stored
+    //
+    std::vector<SeedType> parent_seeds;
+    std::vector<SeedType> child_seeds;
+
+    if (keep_seeds) {
+        seeds.resize(elements.size());
+        seeds[0] = seed;
+    } else {
+        parent_seeds.push_back(seed);
+    }
+
+    for (int d = 1; d <= depth; d++) {
+
+        std::size_t first = depth_start[d];
+        std::size_t parents_first = depth_start[d-1];
+        bool store = keep_seeds || d < depth;
+
+        if (!keep_seeds && store) {
+            child_seeds.resize(depth_start[d+1]-first);
+        }
+
+        executor.parallel_for(first, depth_start[d+1], 64, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t j = begin; j < end; j++) {
+                std::size_t i = parent_index(j);
+                int child_id = j-child_index(i, 0);
+
+                const SeedType& parent_seed = keep_seeds ? seeds[i] : parent_seeds[i-parents_first];
+                SeedType child_seed = spawn_func(elements[i], parent_seed, child_id);
+
+                grow_func(elements[j], make_info(j, d), child_seed);
+
+                if (keep_seeds) {
+                    seeds[j] = child_seed;
+                } else if (store) {
+                    child_seeds[j-first] = child_seed;
+                }
+            }
+        });
+
+        if (!keep_seeds) {
+            parent_seeds.swap(child_seeds);
+        }
+    }
+
+    return *this;
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+const SeedType& CompactFractal<ElemType,SeedType,Arity>::get_seed(std::size_t index) const {
+    if (seeds.empty()) {
+        std::cerr << "CompactFractal::get_seed(): error: the seeds of the elements have not been kept";
+        std::exit(EXIT_FAILURE);
+    }
+    return seeds[index];
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename ComputeType>
+ComputeType CompactFractal<ElemType,SeedType,Arity>::compute(ComputeFunction<ComputeType>& func) {
+
+    if (elements.empty()) {
+        std::cerr << "CompactFractal::compute(): error: cannot compute the function over an empty fractal";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // subtree tiling of the heap layout, see HeapTree
+    auto element_func = [this, &func](std::size_t index, int, const std::vector<ComputeType>& child_rets) -> ComputeType {
+        return func(elements[index], child_rets);
+    };
+
+    return HeapTree<Arity>::template compute<ComputeType>(this->executor(impl_type == ImplType::parallel), depth, element_func);
+}
+
+// end
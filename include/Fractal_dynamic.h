@@ -3,14 +3,20 @@
 
 #include <vector>
 #include <memory>
+#include <future>
+#include <tuple>
+#include <utility>
 #include <cmath>
 #include <iostream>
 #include <omp.h>
 
+#include "Framework.h"
+#include "HeapTree.h"
+
 namespace abstract {
 
 template <typename ElemType, typename SeedType, int Arity> 
-class Fractal { 
+class Fractal : public Framework { 
 
     public:
         
@@ -77,6 +83,60 @@ class Fractal {
 
         template <typename ComputeType>
         ComputeType compute(ComputeFunction<ComputeType>& func);
+
+        // ASYNCHRONOUS INTERFACE
+        //
+        // grow() and compute() started on the executor of the fractal,
+        // returning at once; the futures hold the results. The next
+        // fractal can grow while the current one computes, and the
+        // computations of several fractals sharing a WorkStealingPool
+        // overlap on its workers (with the default OpenMP executor every
+        // call gets a thread of its own).
+        //
+        // The fractal and the function must outlive the call, and the
+        // fractal must not be used until its future is ready
+        //
+        std::future<Fractal_t&> grow_async(int depth);
+        std::future<Fractal_t&> grow_async(int depth, SeedType seed);
+
+        template <typename ComputeType>
+        std::future<ComputeType> compute_async(ComputeFunction<ComputeType>& func);
+
+        // FUSED COMPUTE
+        //
+        // evaluates several compute functions (of possibly different
+        // compute types) in a single traversal of the fractal, which
+        // reads every element once instead of once per function. The
+        // results come in the order of the functions
+        //
+        template <typename... ComputeTypes>
+        std::tuple<ComputeTypes...> compute_fused(ComputeFunction<ComputeTypes>&... funcs);
+
+        // memory taken by the elements of the fractal
+        MemoryUsage memory_usage() const;
+
+        // PARTITIONING
+        //
+        // A balanced fractal can be grown in part: the elements above
+        // split_depth and the subtrees rooted at the elements [first, last)
+        // of split_depth (counted from 0 within the depth). The elements
+        // keep their location in the whole fractal. The parts of a
+        // fractal grown in several processes are computed with
+        // compute_part() and finished with compute_top(), see Distributed.h
+        //
+        void set_partition(int split_depth, size_t first, size_t last);
+        void clear_partition() { part_depth = -1; }
+        bool is_partitioned() const { return part_depth >= 0; }
+        int get_partition_depth() const { return part_depth; }
+
+        // results of the subtrees of the part, in the order of their roots
+        template <typename ComputeType>
+        std::vector<ComputeType> compute_part(ComputeFunction<ComputeType>& func);
+
+        // finishes the computation above the split depth given the
+        // results of all the subtrees rooted at the split depth
+        template <typename ComputeType>
+        ComputeType compute_top(ComputeFunction<ComputeType>& func, const std::vector<ComputeType>& split_rets);
        
         // HELPER FUNCTIONS
 
@@ -150,6 +210,23 @@ class Fractal {
         }
 
     private:
+
+        // elements are allocated from the memory resource of the fractal
+        using ElementPtr = std::unique_ptr<Element,ResourceDeleter<Element,ElemType>>;
+
+        ElementPtr new_element(const ElementInfo& info) {
+            MemoryResource& resource = this->memory_resource();
+            ElementPtr elem(create_object<ElemType>(resource, info), ResourceDeleter<Element,ElemType>(&resource));
+            return elem;
+        }
+
+        // adds the elements of the unbalanced subtree to the usage
+        void subtree_memory_usage(const ElementPtr& elem, MemoryUsage& usage) const;
+
+        // compute function of a tuple of results, which applies
+        // every function of compute_fused() to the element
+        template <typename... ComputeTypes>
+        class FusedFunction;
         
         // private framework computation methods
         // (implement compute() method)
@@ -159,12 +236,42 @@ class Fractal {
         template <typename ComputeType>
         ComputeType compute_balanced(ComputeFunction<ComputeType>& compute_func);
 
+        // results of the subtrees rooted at the elements [lo, hi) of
+        // depth d, computed depth-first by the threads (see HeapTree)
+        template <typename ComputeType>
+        std::vector<ComputeType> compute_subtrees(int d, size_t lo, size_t hi, ComputeFunction<ComputeType>& compute_func);
+
+        // computation of the elements above depth d given
+        // the results of all the elements of depth d
+        template <typename ComputeType>
+        ComputeType compute_above(int d, const std::vector<ComputeType>& rets, ComputeFunction<ComputeType>& compute_func);
+
+        // lays out the elements of the balanced fractal (or of its
+        // part) held by this object; returns their number
+        size_t plan_layout();
+
+        // indices [lo, hi) of the elements of depth d held by this object
+        void depth_range(int d, size_t& lo, size_t& hi) const {
+            if (part_depth < 0 || d < part_depth) {
+                lo = geo_progression[d];
+                hi = geo_progression[d+1];
+            } else {
+                lo = part_lo[d];
+                hi = part_lo[d]+(part_last-part_first)*static_cast<size_t>(std::pow(Arity,d-part_depth));
+            }
+        }
+
+        // position of the element of index j (at depth d) in the elements array
+        size_t slot(size_t j, int d) const {
+            return (part_depth < 0 || d < part_depth) ? j : part_slot[d]+(j-part_lo[d]);
+        }
+
         // private framework construction methods
         // (implement grow() method)
-        std::unique_ptr<Element> grow_unbalanced(SeedType seed, ElementInfo info);
+        ElementPtr grow_unbalanced(SeedType seed, ElementInfo info);
         void grow_balanced(SeedType seed, ElementInfo info);
 
-        std::unique_ptr<Element> grow_unbalanced(ElementInfo info);
+        ElementPtr grow_unbalanced(ElementInfo info);
         void grow_balanced(ElementInfo info);
 
     private:
@@ -182,15 +289,26 @@ class Fractal {
         size_t elements_num;
         size_t leaves_num;
 
+        // partition of the balanced fractal held by this object
+        // (part_depth = -1 stands for the whole fractal)
+        int part_depth;
+        size_t part_first;
+        size_t part_last;
+
+        // first index and first position in the elements
+        // array of the part of every depth below part_depth
+        std::vector<size_t> part_lo;
+        std::vector<size_t> part_slot;
+
         // unbalanced fractal implementation 
         // a pointer to the root element as 
         // the starting point
-        std::unique_ptr<Element> root;
+        ElementPtr root;
         
         // balanced fractal implementation
         // an array of mapped fractal tree elements
         // laid out linearly in memory
-        std::vector<std::unique_ptr<Element>> elements;
+        std::vector<ElementPtr> elements;
         
         // sum of i first members of the 
         // geometric progression 
@@ -295,7 +413,7 @@ class Fractal<ElemType,SeedType,Arity>::Element {
         Element* parent;
         // unbalanced fractal implementation
         // owns its children objects 
-        std::vector<std::unique_ptr<Element>> children;
+        std::vector<ElementPtr> children;
 };
 
 template <typename ElemType, typename SeedType, int Arity> 
@@ -310,6 +428,52 @@ class Fractal<ElemType,SeedType,Arity>::ComputeFunction {
                                      const std::vector<Compute_t>& child_rets) = 0;
 };
 
+template <typename ElemType, typename SeedType, int Arity> 
+template <typename... ComputeTypes>
+class Fractal<ElemType,SeedType,Arity>::FusedFunction : public ComputeFunction<std::tuple<ComputeTypes...>> {
+
+    public:
+
+        using Compute_t = std::tuple<ComputeTypes...>;
+
+        FusedFunction(ComputeFunction<ComputeTypes>&... funcs) : funcs(&funcs...) {}
+
+        Compute_t operator()(ElemType& element, const std::vector<Compute_t>& child_rets) override {
+            return apply(element, child_rets, std::index_sequence_for<ComputeTypes...>());
+        }
+
+    private:
+
+        template <std::size_t... I>
+        Compute_t apply(ElemType& element, const std::vector<Compute_t>& child_rets, std::index_sequence<I...>);
+
+        // the child results of the I-th function
+        template <std::size_t I, typename ComputeType>
+        static void split(const std::vector<Compute_t>& child_rets, std::vector<ComputeType>& rets) {
+            rets.resize(child_rets.size());
+            for (std::size_t k = 0; k < child_rets.size(); k++) {
+                rets[k] = std::get<I>(child_rets[k]);
+            }
+        }
+
+        // the child results of a leaf
+        template <typename ComputeType>
+        static const std::vector<ComputeType>& no_rets() {
+            static const std::vector<ComputeType> none;
+            return none;
+        }
+
+        // child result buffers of the calling thread
+        static std::tuple<std::vector<ComputeTypes>...>& buffers() {
+            static thread_local std::tuple<std::vector<ComputeTypes>...> bufs;
+            return bufs;
+        }
+
+    private:
+
+        std::tuple<ComputeFunction<ComputeTypes>*...> funcs;
+};
+
 #include "Fractal_dynamic.tpp"
 
 } // namespace abstract
@@ -4,7 +4,20 @@
 template <typename ElemType, typename SeedType, int Arity>
 Fractal<ElemType,SeedType,Arity>::Fractal()
     : depth(-1), top_level(-1), root(nullptr), 
-      type(Type::unbalanced), impl_type(ImplType::sequential) {}
+      type(Type::unbalanced), impl_type(ImplType::sequential),
+      part_depth(-1), part_first(0), part_last(0) {}
+
+template <typename ElemType, typename SeedType, int Arity>
+void Fractal<ElemType,SeedType,Arity>::set_partition(int split_depth, size_t first, size_t last) 
+{
+    if (split_depth < 0 || first > last) {
+        std::cerr << "Fractal::set_partition():error: invalid partition!";
+        std::exit(EXIT_FAILURE);
+    }
+    part_depth = split_depth;
+    part_first = first;
+    part_last = last;
+}
  
 template <typename ElemType, typename SeedType, int Arity>
 Fractal<ElemType,SeedType,Arity>::Element::Element(const ElementInfo& elem_info)
@@ -23,6 +36,7 @@ Fractal<ElemType,SeedType,Arity>& Fractal<ElemType,SeedType,Arity>::grow(int dep
     
     // precompute the geometric progression 
     // of level sizes 
+    geo_progression.clear();
     for (int i=0; i<=this->top_level; i++) {
         geo_progression.push_back(geo_sum(i));
     }
@@ -64,6 +78,7 @@ Fractal<ElemType,SeedType,Arity>& Fractal<ElemType,SeedType,Arity>::grow(int dep
     
     // precompute the geometric progression 
     // of level sizes 
+    geo_progression.clear();
     for (int i=0; i<=this->top_level; i++) {
         geo_progression.push_back(geo_sum(i));
     }
@@ -92,7 +107,7 @@ Fractal<ElemType,SeedType,Arity>& Fractal<ElemType,SeedType,Arity>::grow(int dep
 }
 
 template <typename ElemType, typename SeedType, int Arity>
-std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<ElemType,SeedType,Arity>::grow_unbalanced(ElementInfo info) 
+typename Fractal<ElemType,SeedType,Arity>::ElementPtr Fractal<ElemType,SeedType,Arity>::grow_unbalanced(ElementInfo info) 
 {
     if (info.level > 0) {
         
@@ -100,7 +115,7 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
         // CREATE THE ROOT ELEMENT OF THE FRACTAL SUBTREE
         //
         // allocate memory for the root of the fractal subtree 
-        std::unique_ptr<Element> root_elem(new ElemType(info));
+        ElementPtr root_elem = new_element(info);
         // set fractal the element belongs to
         root_elem->set_fractal(this);
         // grow the root element
@@ -117,13 +132,10 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
             if (this->get_impl_type() == Fractal_t::ImplType::parallel) {
                 if (info.depth < 1) {
                     // parallelize 
-                    std::vector<std::unique_ptr<Element>> tmp(info.children_num);
-                    int threads_count = (info.children_num <= 4) ? info.children_num : 4;
-
-                    #pragma omp parallel num_threads(threads_count) shared(tmp)
-                    {
-                        #pragma omp for
-                        for (int child_id = 0; child_id < Arity; child_id++) {
+                    std::vector<ElementPtr> tmp(info.children_num);
+                    this->executor(true).parallel_for(0, Arity, 1, [&](size_t begin, size_t end) {
+                        for (size_t c = begin; c < end; c++) {
+                            int child_id = static_cast<int>(c);
                             // root element of the subtree to be created
                             // element structural info
                             ElementInfo child_info;
@@ -132,11 +144,11 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
                             child_info.child_id = child_id;
                             child_info.index = child_index(info.index,child_id+1);
                             
-                            std::unique_ptr<Element>& child_elem = tmp[child_id];
+                            ElementPtr& child_elem = tmp[child_id];
                             child_elem = std::move(grow_unbalanced(child_info));
                             child_elem->set_parent_element(root_elem.get());
                         }
-                    }
+                    });
 
                     for (int child_id = 0; child_id < info.children_num; child_id++) {
                         root_elem->children.push_back(std::move(tmp[child_id]));
@@ -152,7 +164,7 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
                         child_info.child_id = child_id;
                         child_info.index = child_index(info.index,child_id+1);
                         
-                        std::unique_ptr<Element> child_elem = std::move(grow_unbalanced(child_info));
+                        ElementPtr child_elem = std::move(grow_unbalanced(child_info));
                         child_elem->set_parent_element(root_elem.get());
 
                         root_elem->children.push_back(std::move(child_elem));
@@ -168,7 +180,7 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
                     child_info.child_id = child_id;
                     child_info.index = child_index(info.index,child_id+1);
                     
-                    std::unique_ptr<Element> child_elem = std::move(grow_unbalanced(child_info));
+                    ElementPtr child_elem = std::move(grow_unbalanced(child_info));
                     child_elem->set_parent_element(root_elem.get());
 
                     root_elem->children.push_back(std::move(child_elem));
@@ -179,12 +191,12 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
         return root_elem;
 
     } else {
-        return std::unique_ptr<Element>(nullptr);
+        return ElementPtr(nullptr);
     }
 }
 
 template <typename ElemType, typename SeedType, int Arity>
-std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<ElemType,SeedType,Arity>::grow_unbalanced(SeedType seed, ElementInfo info) 
+typename Fractal<ElemType,SeedType,Arity>::ElementPtr Fractal<ElemType,SeedType,Arity>::grow_unbalanced(SeedType seed, ElementInfo info) 
 {
     if (info.level > 0) {
         
@@ -192,7 +204,7 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
         // CREATE THE ROOT ELEMENT OF THE FRACTAL SUBTREE
         //
         // allocate memory for the root of the fractal subtree 
-        std::unique_ptr<Element> root_elem(new ElemType(info));
+        ElementPtr root_elem = new_element(info);
         // set fractal the element belongs to
         root_elem->set_fractal(this);
         // plant the seed
@@ -211,13 +223,10 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
             if (this->get_impl_type() == Fractal_t::ImplType::parallel) {
                 if (info.depth < 1) {
                     // parallelize 
-                    std::vector<std::unique_ptr<Element>> tmp(info.children_num);
-                    int threads_count = (info.children_num <= 4) ? info.children_num : 4;
-
-                    #pragma omp parallel num_threads(threads_count) shared(tmp)
-                    {
-                        #pragma omp for
-                        for (int child_id = 0; child_id < Arity; child_id++) {
+                    std::vector<ElementPtr> tmp(info.children_num);
+                    this->executor(true).parallel_for(0, Arity, 1, [&](size_t begin, size_t end) {
+                        for (size_t c = begin; c < end; c++) {
+                            int child_id = static_cast<int>(c);
                             // root element of the subtree to be created
                             // element structural info
                             ElementInfo child_info;
@@ -229,11 +238,11 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
                             // seed to grow the child element
                             SeedType child_seed = root_elem->spawn_child_seed(child_id);
                         
-                            std::unique_ptr<Element>& child_elem = tmp[child_id];
+                            ElementPtr& child_elem = tmp[child_id];
                             child_elem = std::move(grow_unbalanced(child_seed, child_info));
                             child_elem->set_parent_element(root_elem.get());
                         }
-                    }
+                    });
 
                     for (int child_id = 0; child_id < info.children_num; child_id++) {
                         root_elem->children.push_back(std::move(tmp[child_id]));
@@ -252,7 +261,7 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
                         // seed to grow the child element
                         SeedType child_seed = root_elem->spawn_child_seed(child_id);
                         
-                        std::unique_ptr<Element> child_elem = std::move(grow_unbalanced(child_seed, child_info));
+                        ElementPtr child_elem = std::move(grow_unbalanced(child_seed, child_info));
                         child_elem->set_parent_element(root_elem.get());
 
                         root_elem->children.push_back(std::move(child_elem));
@@ -271,7 +280,7 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
                     // seed to grow the child element
                     SeedType child_seed = root_elem->spawn_child_seed(child_id);
                     
-                    std::unique_ptr<Element> child_elem = std::move(grow_unbalanced(child_seed, child_info));
+                    ElementPtr child_elem = std::move(grow_unbalanced(child_seed, child_info));
                     child_elem->set_parent_element(root_elem.get());
 
                     root_elem->children.push_back(std::move(child_elem));
@@ -282,170 +291,162 @@ std::unique_ptr<typename Fractal<ElemType,SeedType,Arity>::Element> Fractal<Elem
         return root_elem;
     
     } else {
-        return std::unique_ptr<Element>(nullptr);
+        return ElementPtr(nullptr);
     }
 }
 
+template <typename ElemType, typename SeedType, int Arity>
+size_t Fractal<ElemType,SeedType,Arity>::plan_layout() 
+{
+    if (part_depth < 0) {
+        return elements_num;
+    }
+
+    if (part_depth > depth || part_last > depth_elements_num(part_depth) || part_first > part_last) {
+        std::cerr << "Fractal::grow():error: the partition does not fit the fractal!";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // the elements above the split depth come first,
+    // followed by the parts of the deeper levels
+    part_lo.assign(depth+1, 0);
+    part_slot.assign(depth+1, 0);
+
+    size_t slots = geo_progression[part_depth];
+    for (int d = part_depth; d <= depth; d++) {
+        part_lo[d] = geo_progression[d]+part_first*static_cast<size_t>(std::pow(Arity,d-part_depth));
+        part_slot[d] = slots;
+
+        size_t lo, hi;
+        depth_range(d, lo, hi);
+        slots += hi-lo;
+    }
+
+    return slots;
+}
+
 template <typename ElemType, typename SeedType, int Arity>
 void Fractal<ElemType,SeedType,Arity>::grow_balanced(SeedType seed, ElementInfo info) 
 {
+    elements.clear();
+    elements.resize(plan_layout());
+
+    // a part cut at depth 0 holds either the whole fractal or nothing
+    if (elements.empty()) {
+        return;
+    }
+
     //
     // CREATE THE ROOT ELEMENT OF THE FRACTAL
     //
     // allocate memory for the root of the fractal
-    std::unique_ptr<Element> root_elem(new ElemType(info));
+    ElementPtr root_elem = new_element(info);
     // set fractal the element belongs to
     root_elem->set_fractal(this);
     // plant the seed
     root_elem->plant_seed(seed);
     // grow the root element
     root_elem->grow(seed);
-    
-    if (get_impl_type() == ImplType::parallel) {
-        elements.resize(elements_num);
-        elements[0] = std::move(root_elem);
-    } else {
-        elements.push_back(std::move(root_elem));
-    }
 
-    for (int i = 0; i < elements_num-leaves_num; i++) {
-        
-        // for every fractal element with children
-        // grow all its children
-        
-        if (get_impl_type() == ImplType::parallel) {
+    elements[slot(0,0)] = std::move(root_elem);
 
-            int max_threads = omp_get_max_threads();
-            int threads_count = (Arity <= max_threads) ? Arity : max_threads;
+    Executor& executor = this->executor(get_impl_type() == ImplType::parallel);
 
-            #pragma omp parallel for num_threads(threads_count) shared(elements)
-            for (int j = first_child(i); j <= last_child(i); j++) {
-                ElementInfo child_info;
-                child_info.level = index_to_level(j);
-                child_info.depth = index_to_depth(j);
-                child_info.child_id = j-first_child(i);
-                child_info.index = j;
+    // grow the fractal depth by depth: all the parents
+    // of a depth are in place before their children
+    for (int d = 1; d <= this->depth; d++) {
+        size_t lo, hi;
+        depth_range(d, lo, hi);
 
-                // seed to grow the child element
-                SeedType child_seed = elements[i]->spawn_child_seed(child_info.child_id);
+        executor.parallel_for(lo, hi, 64, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; j++) {
+                int i = (j-1)/Arity;
+                Element* parent = elements[slot(i,d-1)].get();
 
-                // allocate memory for the child element
-                std::unique_ptr<Element> child_elem(new ElemType(child_info));
-                // set fractal the element belongs to
-                child_elem->set_fractal(this);
-                // set parent element
-                child_elem->set_parent_element(elements[i].get());
-                // plant the seed
-                child_elem->plant_seed(child_seed);
-                // grow the child element
-                child_elem->grow(child_seed);
-                
-                elements[j] = std::move(child_elem);
-            }
-        } else {
-            for (int j = first_child(i); j <= last_child(i); j++) {
                 ElementInfo child_info;
-                child_info.level = index_to_level(j);
-                child_info.depth = index_to_depth(j);
+                child_info.level = this->top_level-d;
+                child_info.depth = d;
                 child_info.child_id = j-first_child(i);
                 child_info.index = j;
 
                 // seed to grow the child element
-                SeedType child_seed = elements[i]->spawn_child_seed(child_info.child_id);
+                SeedType child_seed = parent->spawn_child_seed(child_info.child_id);
 
                 // allocate memory for the child element
-                std::unique_ptr<Element> child_elem(new ElemType(child_info));
+                ElementPtr child_elem = new_element(child_info);
                 // set fractal the element belongs to
                 child_elem->set_fractal(this);
                 // set parent element
-                child_elem->set_parent_element(elements[i].get());
+                child_elem->set_parent_element(parent);
                 // plant the seed
                 child_elem->plant_seed(child_seed);
                 // grow the child element
                 child_elem->grow(child_seed);
                 
-                elements.push_back(std::move(child_elem));
+                elements[slot(j,d)] = std::move(child_elem);
             }
-        }
+        });
     }
-
-    return;
 }
 
 template <typename ElemType, typename SeedType, int Arity>
 void Fractal<ElemType,SeedType,Arity>::grow_balanced(ElementInfo info) 
 {
+    elements.clear();
+    elements.resize(plan_layout());
+
+    // a part cut at depth 0 holds either the whole fractal or nothing
+    if (elements.empty()) {
+        return;
+    }
+
     //
     // CREATE THE ROOT ELEMENT OF THE FRACTAL
     //
     // allocate memory for the root of the fractal
-    std::unique_ptr<Element> root_elem(new ElemType(info));
+    ElementPtr root_elem = new_element(info);
     // set fractal the element belongs to
     root_elem->set_fractal(this);
     // grow the root element
     root_elem->grow();
-    
-    if (get_impl_type() == ImplType::parallel) {
-        elements.resize(elements_num);
-        elements[0] = std::move(root_elem);
-    } else {
-        elements.push_back(std::move(root_elem));
-    }
 
-    for (int i = 0; i < elements_num-leaves_num; i++) {
-        
-        // for every fractal element with children
-        // grow all its children
-        
-        if (get_impl_type() == ImplType::parallel) {
+    elements[slot(0,0)] = std::move(root_elem);
 
-            int max_threads = omp_get_max_threads();
-            int threads_count = (Arity <= max_threads) ? Arity : max_threads;
+    Executor& executor = this->executor(get_impl_type() == ImplType::parallel);
 
-            #pragma omp parallel for num_threads(threads_count) shared(elements)
-            for (int j = first_child(i); j <= last_child(i); j++) {
-                ElementInfo child_info;
-                child_info.level = index_to_level(j);
-                child_info.depth = index_to_depth(j);
-                child_info.child_id = j-first_child(i);
-                child_info.index = j;
+    // grow the fractal depth by depth: all the parents
+    // of a depth are in place before their children
+    for (int d = 1; d <= this->depth; d++) {
+        size_t lo, hi;
+        depth_range(d, lo, hi);
+
+        executor.parallel_for(lo, hi, 64, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; j++) {
+                int i = (j-1)/Arity;
+                Element* parent = elements[slot(i,d-1)].get();
 
-                // allocate memory for the child element
-                std::unique_ptr<Element> child_elem(new ElemType(child_info));
-                // set fractal the element belongs to
-                child_elem->set_fractal(this);
-                // set parent element
-                child_elem->set_parent_element(elements[i].get());
-                // grow the child element
-                child_elem->grow();
-                
-                elements[j] = std::move(child_elem);
-            }
-        } else {
-            for (int j = first_child(i); j <= last_child(i); j++) {
                 ElementInfo child_info;
-                child_info.level = index_to_level(j);
-                child_info.depth = index_to_depth(j);
+                child_info.level = this->top_level-d;
+                child_info.depth = d;
                 child_info.child_id = j-first_child(i);
                 child_info.index = j;
 
                 // allocate memory for the child element
-                std::unique_ptr<Element> child_elem(new ElemType(child_info));
+                ElementPtr child_elem = new_element(child_info);
                 // set fractal the element belongs to
                 child_elem->set_fractal(this);
                 // set parent element
-                child_elem->set_parent_element(elements[i].get());
+                child_elem->set_parent_element(parent);
                 // grow the child element
                 child_elem->grow();
                 
-                elements.push_back(std::move(child_elem));
+                elements[slot(j,d)] = std::move(child_elem);
             }
-        }
+        });
     }
-
-    return;
 }
 
+
 template <typename ElemType, typename SeedType, int Arity>
 template <typename ComputeType>
 ComputeType Fractal<ElemType,SeedType,Arity>::compute(ComputeFunction<ComputeType>& compute_func) {
@@ -459,6 +460,59 @@ ComputeType Fractal<ElemType,SeedType,Arity>::compute(ComputeFunction<ComputeTyp
     }
 }
 
+template <typename ElemType, typename SeedType, int Arity>
+std::future<Fractal<ElemType,SeedType,Arity>&> Fractal<ElemType,SeedType,Arity>::grow_async(int depth) {
+    return this->run_async([this, depth]() -> Fractal_t& { return grow(depth); });
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+std::future<Fractal<ElemType,SeedType,Arity>&> Fractal<ElemType,SeedType,Arity>::grow_async(int depth, SeedType seed) {
+    return this->run_async([this, depth, seed]() -> Fractal_t& { return grow(depth, seed); });
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename ComputeType>
+std::future<ComputeType> Fractal<ElemType,SeedType,Arity>::compute_async(ComputeFunction<ComputeType>& compute_func) {
+    ComputeFunction<ComputeType>* func = &compute_func;
+    return this->run_async([this, func]() { return this->template compute<ComputeType>(*func); });
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename... ComputeTypes>
+std::tuple<ComputeTypes...> Fractal<ElemType,SeedType,Arity>::compute_fused(ComputeFunction<ComputeTypes>&... funcs) {
+    static_assert(sizeof...(ComputeTypes) > 0, "Fractal::compute_fused(): no compute functions given");
+
+    // the traversals of both fractal types carry
+    // the tuples of results from the children up
+    FusedFunction<ComputeTypes...> fused(funcs...);
+    return this->template compute<std::tuple<ComputeTypes...>>(fused);
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename... ComputeTypes>
+template <std::size_t... I>
+std::tuple<ComputeTypes...> Fractal<ElemType,SeedType,Arity>::FusedFunction<ComputeTypes...>::apply(
+        ElemType& element, const std::vector<Compute_t>& child_rets, std::index_sequence<I...>) {
+
+    // the functions are called in order
+    if (child_rets.empty()) {
+        // most of the elements are leaves
+        return Compute_t { (*std::get<I>(funcs))(element, no_rets<ComputeTypes>())... };
+    }
+
+    // the buffers are taken over for the call, so that a fused
+    // compute run inside one of the functions gets its own
+    std::tuple<std::vector<ComputeTypes>...> rets = std::move(buffers());
+
+    int expand[] = { 0, (split<I>(child_rets, std::get<I>(rets)), 0)... };
+    (void) expand;
+
+    Compute_t ret { (*std::get<I>(funcs))(element, std::get<I>(rets))... };
+
+    buffers() = std::move(rets);
+    return ret;
+}
+
 template <typename ElemType, typename SeedType, int Arity>
 template <typename ComputeType>
 ComputeType Fractal<ElemType,SeedType,Arity>::compute_unbalanced(ComputeFunction<ComputeType>& compute_func) {
@@ -478,57 +532,84 @@ ComputeType Fractal<ElemType,SeedType,Arity>::compute_balanced(ComputeFunction<C
         std::exit(EXIT_FAILURE);
     }
 
-    std::vector<ComputeType> computed_rets(elements_num);
-    
-    if (this->get_impl_type() == ImplType::parallel) {
-        
-        int max_threads = omp_get_max_threads();
-        int threads_count;
-        
-        // precompute leaves
-        
-        threads_count = (leaves_num < max_threads) ? leaves_num : max_threads;
+    if (is_partitioned()) {
+        std::cerr << "Fractal::compute(): error: a partitioned fractal is computed with compute_part() and compute_top()";
+        std::exit(EXIT_FAILURE);
+    }
 
-        #pragma omp parallel for num_threads(threads_count) shared(elements,computed_rets)
-        for (int i = elements_num-1; i >= elements_num-leaves_num; i--) {
-            std::vector<ComputeType> leaf_ret_vals;
-            computed_rets[i] = compute_func(*(static_cast<ElemType*>(elements[i].get())), leaf_ret_vals);
-        }
+    // OPTIMIZATION
+    //
+    // subtree tiling of the heap layout, see HeapTree
+    //
+    size_t threads_num = this->executor(get_impl_type() == ImplType::parallel).concurrency();
+    int tile_depth = HeapTree<Arity>::tile_depth(this->depth, threads_num);
 
-        for (int lvl = 2; lvl <= this->top_level; lvl++) {
-            
-            threads_count = (level_elements_num(lvl) < max_threads) ? level_elements_num(lvl) : max_threads;
+    size_t lo, hi;
+    depth_range(tile_depth, lo, hi);
 
-            #pragma omp parallel for num_threads(threads_count) shared(elements,computed_rets,lvl)
-            for (int i = level_start_index(lvl); i <= level_end_index(lvl); i++) {
-                std::vector<ComputeType> ret_vals(Arity);
-                // get child computation results 
-                for (int j = first_child(i); j <= last_child(i); j++) {
-                    ret_vals[j-first_child(i)] = computed_rets[j];
-                }
-                // perform computation for the element
-                computed_rets[i] = compute_func(*(static_cast<ElemType*>(elements[i].get())), ret_vals);
-            }
-        }
-    } else {
-        // precompute leaves
-        std::vector<ComputeType> leaf_ret_vals;
-        for (int i = elements_num-1; i >= elements_num-leaves_num; i--) {
-            computed_rets[i] = compute_func(*(static_cast<ElemType*>(elements[i].get())), leaf_ret_vals);
-        }
+    std::vector<ComputeType> tile_rets = compute_subtrees(tile_depth, lo, hi, compute_func);
 
-        for (int i = elements_num-leaves_num-1; i >= 0; i--) {
-            std::vector<ComputeType> ret_vals(Arity);
-            // get child computation results 
-            for (int j = first_child(i); j <= last_child(i); j++) {
-                ret_vals[j-first_child(i)] = computed_rets[j];
-            }
-            // perform computation for the element
-            computed_rets[i] = compute_func(*(static_cast<ElemType*>(elements[i].get())), ret_vals);
-        }
+    return compute_above(tile_depth, tile_rets, compute_func);
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename ComputeType>
+std::vector<ComputeType> Fractal<ElemType,SeedType,Arity>::compute_part(ComputeFunction<ComputeType>& compute_func) {
+
+    if (!is_partitioned() || type != Type::balanced || depth < 0) {
+        std::cerr << "Fractal::compute_part(): error: the fractal has not been grown in part";
+        std::exit(EXIT_FAILURE);
     }
-    
-    return computed_rets[0];
+
+    size_t lo, hi;
+    depth_range(part_depth, lo, hi);
+
+    return compute_subtrees(part_depth, lo, hi, compute_func);
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename ComputeType>
+ComputeType Fractal<ElemType,SeedType,Arity>::compute_top(ComputeFunction<ComputeType>& compute_func,
+                                                          const std::vector<ComputeType>& split_rets) {
+
+    if (!is_partitioned() || type != Type::balanced || depth < 0) {
+        std::cerr << "Fractal::compute_top(): error: the fractal has not been grown in part";
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (split_rets.size() != depth_elements_num(part_depth)) {
+        std::cerr << "Fractal::compute_top(): error: expected the results of all the " 
+                  << depth_elements_num(part_depth) << " subtrees of the split depth";
+        std::exit(EXIT_FAILURE);
+    }
+
+    return compute_above(part_depth, split_rets, compute_func);
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename ComputeType>
+std::vector<ComputeType> Fractal<ElemType,SeedType,Arity>::compute_subtrees(int d, size_t lo, size_t hi,
+                                                                            ComputeFunction<ComputeType>& compute_func) {
+
+    auto element_func = [this, &compute_func](size_t index, int d, const std::vector<ComputeType>& child_rets) -> ComputeType {
+        return compute_func(*(static_cast<ElemType*>(elements[slot(index,d)].get())), child_rets);
+    };
+
+    return HeapTree<Arity>::template compute_subtrees<ComputeType>(this->executor(get_impl_type() == ImplType::parallel),
+                                                                   this->depth, d, lo, hi, element_func);
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+template <typename ComputeType>
+ComputeType Fractal<ElemType,SeedType,Arity>::compute_above(int d, const std::vector<ComputeType>& rets,
+                                                            ComputeFunction<ComputeType>& compute_func) {
+
+    // the elements above the split depth are not partitioned
+    auto element_func = [this, &compute_func](size_t index, int, const std::vector<ComputeType>& child_rets) -> ComputeType {
+        return compute_func(*(static_cast<ElemType*>(elements[index].get())), child_rets);
+    };
+
+    return HeapTree<Arity>::template compute_above<ComputeType>(d, rets, element_func);
 }
 
 template <typename ElemType, typename SeedType, int Arity>
@@ -545,20 +626,12 @@ ComputeType Fractal<ElemType,SeedType,Arity>::Element::compute(ComputeFunction<C
                 // parallelize 
                 //std::vector<ComputeType> tmp(info.children_num);
                 ComputeType tmp[Arity];
-                //int threads_count = (info.children_num <= 4) ? info.children_num : 4;
-                int threads_count = Arity;
-
-                #pragma omp parallel num_threads(threads_count) shared(tmp)
-                {
-                    #pragma omp for schedule(static)
-                    for (int i = 0; i < Arity; i++) {
-
-                        //int tid = omp_get_thread_num();
-                        //printf("Apply omp_thread=%d\n", tid);
 
+                fractal->executor(true).parallel_for(0, Arity, 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
                         tmp[i] = children[i]->template compute<ComputeType>(compute_func);
                     }
-                }
+                });
 
                 for (int i = 0; i < Arity; i++) {
                     ret_vals.push_back(tmp[i]);
@@ -578,4 +651,43 @@ ComputeType Fractal<ElemType,SeedType,Arity>::Element::compute(ComputeFunction<C
     return compute_func(*(static_cast<ElemType*>(this)), ret_vals);
 }
 
+template <typename ElemType, typename SeedType, int Arity>
+MemoryUsage Fractal<ElemType,SeedType,Arity>::memory_usage() const {
+
+    MemoryUsage usage;
+
+    if (type == Type::balanced) {
+        std::size_t n = 0;
+        for (const ElementPtr& elem : elements) {
+            if (elem != nullptr) {
+                // the resource set now may not be the one the element came from
+                usage.add_blocks(*elem.get_deleter().get_resource(), 1, sizeof(ElemType), alignof(ElemType));
+                n++;
+            }
+        }
+        usage.payload += n*(sizeof(ElemType)-sizeof(Element));
+        usage.structural += n*sizeof(Element);
+        usage.add_vector(&MemoryUsage::structural, elements);
+    } else if (root != nullptr) {
+        subtree_memory_usage(root, usage);
+    }
+
+    usage.add_vector(&MemoryUsage::structural, geo_progression);
+
+    return usage;
+}
+
+template <typename ElemType, typename SeedType, int Arity>
+void Fractal<ElemType,SeedType,Arity>::subtree_memory_usage(const ElementPtr& elem, MemoryUsage& usage) const {
+
+    usage.payload += sizeof(ElemType)-sizeof(Element);
+    usage.structural += sizeof(Element);
+    usage.add_blocks(*elem.get_deleter().get_resource(), 1, sizeof(ElemType), alignof(ElemType));
+    usage.add_vector(&MemoryUsage::structural, elem->children);
+
+    for (const ElementPtr& child : elem->children) {
+        subtree_memory_usage(child, usage);
+    }
+}
+
 // end
@@ -2,17 +2,26 @@
 #define FRACTAL_H
 
 #include <cmath>
+#include <cstddef>
 
+#include <array>
 #include <iostream>
+#include <type_traits>
 #include <omp.h>
 
 #include "Sequence.h"
+#include "Framework.h"
 
 namespace abstract {
 
 template <typename ElemType, int ChildNum>
 class FractalElement;
 
+// the depth of the fractal is either a runtime grow() argument
+// (Depth = -1) or fixed at compile time
+template <typename ElemType, int ChildNum, int Depth = -1>
+class Fractal;
+
 class FractalElementInfo {
     
     public:
@@ -33,20 +42,24 @@ class FractalElementInfo {
 };
 
 template <typename ElemType, int ChildNum>
-class Fractal {
+class Fractal<ElemType,ChildNum,-1> : public Framework {
+
+    friend class FractalElement<ElemType,ChildNum>;
 
     public:
         
         using Fractal_t = Fractal<ElemType,ChildNum>;
 
         Fractal() 
-            : root(nullptr) 
+            : root(nullptr), root_resource(nullptr) 
         {
             children_num = ChildNum;
         }
         
         ~Fractal() {
-            delete root;
+            if (root != nullptr) {
+                destroy_object(*root_resource, root);
+            }
         }
 
         // Fractal grow method
@@ -66,10 +79,16 @@ class Fractal {
         template <typename WalkFunc,typename ReturnType>
         ReturnType walk(WalkFunc apply_func);
 
+        // memory taken by the fractal elements and their data
+        MemoryUsage memory_usage() const;
+
     private:
 
         // Fractal's root element
         FractalElement<ElemType,ChildNum>* root; 
+        // the resource the root has been allocated from, which
+        // is kept alive by the framework even if replaced later
+        MemoryResource* root_resource;
 
         // Fractal's structural information
         int children_num;
@@ -112,10 +131,19 @@ class FractalElement {
 
         bool has_children() { return !children.empty(); }
 
+        // adds the elements of the subtree to the usage
+        void memory_usage(MemoryUsage& usage) const;
+
     private:
         
+        // elements and their data are allocated from the memory
+        // resource the fractal had when the element was grown
+        MemoryResource& memory_resource() const {
+            return *resource;
+        }
+
         ElemType* allocate_element() {
-            return new ElemType;   
+            return create_object<ElemType>(memory_resource());
         }
 
     private:
@@ -125,7 +153,10 @@ class FractalElement {
         
         // structural links with parent and children fractal elements
         FractalElement_t* parent;
-        Sequence<FractalElement_t*> children;
+        InlineSequence<FractalElement_t*,ChildNum> children;
+
+        // resource of the element, its data and its children
+        MemoryResource* resource;
 
         // element information
         FractalElementInfo info;
@@ -134,6 +165,122 @@ class FractalElement {
         ElemType* elem;
 };
 
+//
+// Fractal<ElemType,ChildNum,Depth> class
+//
+// Complete fractal of a fixed depth for small latency-critical trees.
+// The layout is computed at compile time: elements are stored by value
+// in a std::array laid out as a heap (children of the element i are
+// ChildNum*i+1 .. ChildNum*i+ChildNum), and grow(), apply() and walk()
+// expand into template recursion the compiler fully inlines, without
+// runtime structural checks, allocations or threads.
+//
+// Functions receive the results of the children in a std::array
+// (of size 0 at the leaves), so they are usually generic lambdas:
+//
+//     [](ElemType* elem, auto& child_rets) { ... }
+//
+template <typename ElemType, int ChildNum, int Depth>
+class Fractal {
+
+    static_assert(ChildNum > 0, "Fractal: the number of children must be positive");
+    static_assert(Depth >= 0, "Fractal: the depth must not be negative");
+
+    public:
+
+        using Fractal_t = Fractal<ElemType,ChildNum,Depth>;
+
+        static constexpr int children_num = ChildNum;
+        static constexpr int depth = Depth;
+        static constexpr int top_level = Depth+1;
+
+        // the number of elements of the first levels_num levels
+        static constexpr std::size_t geo_sum(int levels_num) {
+            return (levels_num == 0) ? 0 : 1+ChildNum*geo_sum(levels_num-1);
+        }
+
+        static constexpr std::size_t elements_num = geo_sum(Depth+1);
+
+        Fractal() : elements() {}
+        ~Fractal() {}
+
+        // children are grown before their parent; the seed of the
+        // child i is produced by next_growth_seed_func(seed, child_seed, i)
+        template <typename GrowthFuncType,
+                  typename GrowthSeedType,
+                  typename NextGrowthSeedFuncType>
+        void grow(GrowthFuncType growth_func,
+                  GrowthSeedType growth_seed,
+                  NextGrowthSeedFuncType next_growth_seed_func);
+
+        // apply_func(ElemType*, std::array<ReturnType,N>& child_rets)
+        template <typename ApplyFunc,typename ReturnType>
+        ReturnType apply(ApplyFunc apply_func);
+
+        // walk_func(ElemType*, const FractalElementInfo&, std::array<ReturnType,N>& child_rets)
+        template <typename WalkFunc,typename ReturnType>
+        ReturnType walk(WalkFunc walk_func);
+
+        ElemType& element(std::size_t index) { return elements[index]; }
+
+    private:
+
+        // leaf tags: std::true_type for the elements at depth D == Depth
+        template <int D>
+        using is_leaf = std::integral_constant<bool, (D == Depth)>;
+
+        // tags of the unrolled loops over the children
+        template <int C>
+        using has_child = std::integral_constant<bool, (C < ChildNum)>;
+
+        static FractalElementInfo element_info(int d) {
+            return FractalElementInfo(Depth-d+1, d, -1, ChildNum);
+        }
+
+        template <int Index, int D, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+        void grow_element(GrowthFuncType& growth_func, const GrowthSeedType& growth_seed,
+                          NextGrowthSeedFuncType& next_growth_seed_func, std::true_type);
+
+        template <int Index, int D, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+        void grow_element(GrowthFuncType& growth_func, const GrowthSeedType& growth_seed,
+                          NextGrowthSeedFuncType& next_growth_seed_func, std::false_type);
+
+        template <int Index, int D, int C, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+        void grow_children(GrowthFuncType& growth_func, const GrowthSeedType& growth_seed,
+                           NextGrowthSeedFuncType& next_growth_seed_func, std::true_type);
+
+        template <int Index, int D, int C, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+        void grow_children(GrowthFuncType&, const GrowthSeedType&, NextGrowthSeedFuncType&, std::false_type) {}
+
+        template <int Index, int D, typename ApplyFunc, typename ReturnType>
+        ReturnType apply_element(ApplyFunc& apply_func, std::true_type);
+
+        template <int Index, int D, typename ApplyFunc, typename ReturnType>
+        ReturnType apply_element(ApplyFunc& apply_func, std::false_type);
+
+        template <int Index, int D, int C, typename ApplyFunc, typename ReturnType>
+        void apply_children(ApplyFunc& apply_func, std::array<ReturnType,ChildNum>& child_rets, std::true_type);
+
+        template <int Index, int D, int C, typename ApplyFunc, typename ReturnType>
+        void apply_children(ApplyFunc&, std::array<ReturnType,ChildNum>&, std::false_type) {}
+
+        template <int Index, int D, typename WalkFunc, typename ReturnType>
+        ReturnType walk_element(WalkFunc& walk_func, std::true_type);
+
+        template <int Index, int D, typename WalkFunc, typename ReturnType>
+        ReturnType walk_element(WalkFunc& walk_func, std::false_type);
+
+        template <int Index, int D, int C, typename WalkFunc, typename ReturnType>
+        void walk_children(WalkFunc& walk_func, std::array<ReturnType,ChildNum>& child_rets, std::true_type);
+
+        template <int Index, int D, int C, typename WalkFunc, typename ReturnType>
+        void walk_children(WalkFunc&, std::array<ReturnType,ChildNum>&, std::false_type) {}
+
+    private:
+
+        std::array<ElemType,elements_num> elements;
+};
+
 #include "Fractal_static.tpp"
 
 } // namespace abstract
@@ -18,8 +18,15 @@ void Fractal<ElemType,ChildNum>::grow(int depth,
     info.depth = 0;
     info.children_num = this->children_num;
 
+    if (root != nullptr) {
+        destroy_object(*root_resource, root);
+        root = nullptr;
+    }
+
     if (this->depth >= 0) {
-        root = new FractalElement<ElemType,ChildNum>(info, // current fractal element info
+        root_resource = &this->memory_resource();
+        root = create_object<FractalElement<ElemType,ChildNum>>(*root_resource,
+                                                     info, // current fractal element info
                                                      this, // fractal the element belongs to
                                                      this->depth, // fractal depth
                                                      nullptr, // parent fractal element (root does not have a parent pointer)
@@ -64,7 +71,9 @@ FractalElement<ElemType,ChildNum>::FractalElement(const FractalElementInfo& elem
                                                   GrowthSeedType growth_func_param,
                                                   NextGrowthSeedFuncType next_growth_seed_func,
                                                   GrowthStopFuncType growth_stop_func)
-    : info(elem_info), fractal(fractal), parent(elem_parent)
+    : fractal(fractal), parent(elem_parent),
+      resource((elem_parent != nullptr) ? elem_parent->resource : &fractal->memory_resource()),
+      info(elem_info)
 {
     elem = allocate_element();
     
@@ -92,7 +101,8 @@ FractalElement<ElemType,ChildNum>::FractalElement(const FractalElementInfo& elem
                     GrowthSeedType child_growth_seed;
                     next_growth_seed_func(growth_func_param, child_growth_seed, i);
 
-                    tmp[i] = new FractalElement<ElemType,ChildNum>(child_info,
+                    tmp[i] = create_object<FractalElement_t>(memory_resource(),
+                                                                   child_info,
                                                                    fractal,
                                                                    fractal_depth,
                                                                    this,
@@ -118,7 +128,8 @@ FractalElement<ElemType,ChildNum>::FractalElement(const FractalElementInfo& elem
                 GrowthSeedType child_growth_seed;
                 next_growth_seed_func(growth_func_param, child_growth_seed, i);
                 
-                children.add(new FractalElement<ElemType,ChildNum>(child_info,
+                children.add(create_object<FractalElement_t>(memory_resource(),
+                                                                   child_info,
                                                                    fractal,
                                                                    fractal_depth,
                                                                    this,
@@ -137,11 +148,38 @@ FractalElement<ElemType,ChildNum>::FractalElement(const FractalElementInfo& elem
 template <typename ElemType, int ChildNum>
 FractalElement<ElemType,ChildNum>::~FractalElement() {
     
-    delete elem;
+    destroy_object(memory_resource(), elem);
 
     if (!children.empty()) {
         for (int i = 0; i < info.children_num; i++) {
-            delete children[i];
+            destroy_object(memory_resource(), children[i]);
+        }
+    }
+}
+
+template <typename ElemType, int ChildNum>
+MemoryUsage Fractal<ElemType,ChildNum>::memory_usage() const {
+    MemoryUsage usage;
+    if (root != nullptr) {
+        root->memory_usage(usage);
+    }
+    return usage;
+}
+
+template <typename ElemType, int ChildNum>
+void FractalElement<ElemType,ChildNum>::memory_usage(MemoryUsage& usage) const {
+
+    MemoryResource& resource = memory_resource();
+
+    // the element data is allocated separately from the element
+    usage.payload += sizeof(ElemType);
+    usage.structural += sizeof(FractalElement_t);
+    usage.add_blocks(resource, 1, sizeof(ElemType), alignof(ElemType));
+    usage.add_blocks(resource, 1, sizeof(FractalElement_t), alignof(FractalElement_t));
+
+    if (!children.empty()) {
+        for (int i = 0; i < info.children_num; i++) {
+            children[i]->memory_usage(usage);
         }
     }
 }
@@ -233,4 +271,102 @@ ReturnType FractalElement<ElemType,ChildNum>::walk(WalkFunc walk_func) {
     return walk_func(this, ret_vals);
 }
 
+//
+// compile-time depth fractal
+//
+
+template <typename ElemType, int ChildNum, int Depth>
+template <typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+void Fractal<ElemType,ChildNum,Depth>::grow(GrowthFuncType growth_func,
+                                            GrowthSeedType growth_seed,
+                                            NextGrowthSeedFuncType next_growth_seed_func)
+{
+    grow_element<0,0>(growth_func, growth_seed, next_growth_seed_func, is_leaf<0>());
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+void Fractal<ElemType,ChildNum,Depth>::grow_element(GrowthFuncType& growth_func, const GrowthSeedType& growth_seed,
+                                                    NextGrowthSeedFuncType& next_growth_seed_func, std::true_type)
+{
+    growth_func(&elements[Index], element_info(D), growth_seed);
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+void Fractal<ElemType,ChildNum,Depth>::grow_element(GrowthFuncType& growth_func, const GrowthSeedType& growth_seed,
+                                                    NextGrowthSeedFuncType& next_growth_seed_func, std::false_type)
+{
+    grow_children<Index,D,0>(growth_func, growth_seed, next_growth_seed_func, has_child<0>());
+    growth_func(&elements[Index], element_info(D), growth_seed);
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, int C, typename GrowthFuncType, typename GrowthSeedType, typename NextGrowthSeedFuncType>
+void Fractal<ElemType,ChildNum,Depth>::grow_children(GrowthFuncType& growth_func, const GrowthSeedType& growth_seed,
+                                                     NextGrowthSeedFuncType& next_growth_seed_func, std::true_type)
+{
+    GrowthSeedType child_growth_seed;
+    next_growth_seed_func(growth_seed, child_growth_seed, C);
+
+    grow_element<ChildNum*Index+1+C,D+1>(growth_func, child_growth_seed, next_growth_seed_func, is_leaf<D+1>());
+    grow_children<Index,D,C+1>(growth_func, growth_seed, next_growth_seed_func, has_child<C+1>());
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <typename ApplyFunc, typename ReturnType>
+ReturnType Fractal<ElemType,ChildNum,Depth>::apply(ApplyFunc apply_func) {
+    return apply_element<0,0,ApplyFunc,ReturnType>(apply_func, is_leaf<0>());
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, typename ApplyFunc, typename ReturnType>
+ReturnType Fractal<ElemType,ChildNum,Depth>::apply_element(ApplyFunc& apply_func, std::true_type) {
+    std::array<ReturnType,0> child_rets;
+    return apply_func(&elements[Index], child_rets);
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, typename ApplyFunc, typename ReturnType>
+ReturnType Fractal<ElemType,ChildNum,Depth>::apply_element(ApplyFunc& apply_func, std::false_type) {
+    std::array<ReturnType,ChildNum> child_rets;
+    apply_children<Index,D,0,ApplyFunc,ReturnType>(apply_func, child_rets, has_child<0>());
+    return apply_func(&elements[Index], child_rets);
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, int C, typename ApplyFunc, typename ReturnType>
+void Fractal<ElemType,ChildNum,Depth>::apply_children(ApplyFunc& apply_func, std::array<ReturnType,ChildNum>& child_rets, std::true_type) {
+    child_rets[C] = apply_element<ChildNum*Index+1+C,D+1,ApplyFunc,ReturnType>(apply_func, is_leaf<D+1>());
+    apply_children<Index,D,C+1,ApplyFunc,ReturnType>(apply_func, child_rets, has_child<C+1>());
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <typename WalkFunc, typename ReturnType>
+ReturnType Fractal<ElemType,ChildNum,Depth>::walk(WalkFunc walk_func) {
+    return walk_element<0,0,WalkFunc,ReturnType>(walk_func, is_leaf<0>());
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, typename WalkFunc, typename ReturnType>
+ReturnType Fractal<ElemType,ChildNum,Depth>::walk_element(WalkFunc& walk_func, std::true_type) {
+    std::array<ReturnType,0> child_rets;
+    return walk_func(&elements[Index], element_info(D), child_rets);
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, typename WalkFunc, typename ReturnType>
+ReturnType Fractal<ElemType,ChildNum,Depth>::walk_element(WalkFunc& walk_func, std::false_type) {
+    std::array<ReturnType,ChildNum> child_rets;
+    walk_children<Index,D,0,WalkFunc,ReturnType>(walk_func, child_rets, has_child<0>());
+    return walk_func(&elements[Index], element_info(D), child_rets);
+}
+
+template <typename ElemType, int ChildNum, int Depth>
+template <int Index, int D, int C, typename WalkFunc, typename ReturnType>
+void Fractal<ElemType,ChildNum,Depth>::walk_children(WalkFunc& walk_func, std::array<ReturnType,ChildNum>& child_rets, std::true_type) {
+    child_rets[C] = walk_element<ChildNum*Index+1+C,D+1,WalkFunc,ReturnType>(walk_func, is_leaf<D+1>());
+    walk_children<Index,D,C+1,WalkFunc,ReturnType>(walk_func, child_rets, has_child<C+1>());
+}
+
 // end
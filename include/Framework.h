@@ -1,26 +1,331 @@
 #ifndef ABSTRACT_FRAMEWORK_H
 #define ABSTRACT_FRAMEWORK_H
 
+#include <cstdlib>
 #include <iostream>
 #include <vector>
+#include <deque>
 #include <memory>
+#include <functional>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <omp.h>
+
+#include "Memory.h"
 
 namespace abstract {
 
+//
+// Executor class
+//
+// Backend running the parallel loops and tasks of the skeletons.
+// All the calls are blocking: they return when all the work they
+// have been given is done. Calls may be nested, i.e. issued from
+// inside the loop bodies and tasks of an enclosing call, in which
+// case the work is spread over the threads the executor already
+// runs instead of spawning new ones
+//
+class Executor {
+
+    public:
+
+        using Range = std::function<void(std::size_t,std::size_t)>;
+        using Task = std::function<void()>;
+
+        virtual ~Executor() {}
+
+        // the number of threads the work is spread over
+        virtual int concurrency() const = 0;
+
+        // splits [begin, end) into chunks of at least grain iterations
+        // and calls body(chunk_begin, chunk_end) for every chunk
+        virtual void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Range& body) = 0;
+
+        // runs all the tasks
+        virtual void invoke(const std::vector<Task>& tasks) = 0;
+
+        // starts the task and returns without waiting for it; runs it
+        // on the shared async_pool() unless the executor has threads
+        // of its own. The task must not throw: it has nobody to report
+        // its errors to
+        virtual void spawn(Task task);
+
+    protected:
+
+        // a few chunks per thread leave room for load balancing
+        std::size_t chunks_num(std::size_t n, std::size_t grain) const {
+            std::size_t max_chunks = (n+grain-1)/((grain > 0) ? grain : 1);
+            std::size_t chunks = 4*static_cast<std::size_t>(concurrency());
+            return (chunks < max_chunks) ? chunks : max_chunks;
+        }
+
+        static std::size_t chunk_begin(std::size_t begin, std::size_t n, std::size_t chunks, std::size_t c) {
+            return begin+(n*c)/chunks;
+        }
+};
+
+//
+// SequentialExecutor class
+//
+// runs everything on the calling thread, in order
+//
+class SequentialExecutor : public Executor {
+
+    public:
+
+        int concurrency() const override { return 1; }
+
+        void parallel_for(std::size_t begin, std::size_t end, std::size_t, const Range& body) override {
+            if (begin < end) {
+                body(begin, end);
+            }
+        }
+
+        void invoke(const std::vector<Task>& tasks) override {
+            for (const Task& task : tasks) {
+                task();
+            }
+        }
+
+        void spawn(Task task) override {
+            task();
+        }
+};
+
+//
+// OpenMPExecutor class
+//
+// Forks an OpenMP team per call. Nested calls made from inside a
+// parallel region are turned into tasks of the enclosing team
+//
+class OpenMPExecutor : public Executor {
+
+    public:
+
+        // threads_num = 0 stands for omp_get_max_threads()
+        OpenMPExecutor(int threads_num = 0)
+            : threads_num(threads_num) {}
+
+        int concurrency() const override {
+            return (threads_num > 0) ? threads_num : omp_get_max_threads();
+        }
+
+        void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Range& body) override;
+        void invoke(const std::vector<Task>& tasks) override;
+
+    private:
+
+        int threads_num;
+};
+
+//
+// WorkStealingPool class
+//
+// Persistent pool of worker threads, each with its own deque of
+// jobs. Workers take their own jobs from the back (the most recently
+// pushed, still in cache) and steal the jobs of others from the front.
+// A thread waiting for its jobs to finish keeps executing jobs, so
+// nested calls neither block workers nor create extra threads, and
+// sleeps once there is nothing left to steal. Calls from threads
+// outside the pool go through a shared injection deque.
+//
+// Spawned tasks are kept apart in a root deque which only the idle
+// workers take from: a thread waiting for its jobs never starts an
+// unrelated, possibly long, task on its stack.
+//
+// An exception thrown by a loop chunk or a task cancels the jobs of
+// the call not started yet; the first one is rethrown by the call
+// once all its running jobs have finished
+//
+class WorkStealingPool : public Executor {
+
+    public:
+
+        // threads_num = 0 stands for the hardware concurrency
+        WorkStealingPool(int threads_num = 0);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        int concurrency() const override { return workers_num; }
+
+        void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Range& body) override;
+        void invoke(const std::vector<Task>& tasks) override;
+
+        // queued as a root job owning the task
+        void spawn(Task task) override;
+
+    private:
+
+        // jobs submitted by one call
+        struct Group {
+            std::atomic<std::size_t> pending;
+            std::atomic<bool> failed;
+            // set by the job which sets failed
+            std::exception_ptr error;
+
+            Group(std::size_t jobs_num) : pending(jobs_num), failed(false), error() {}
+
+            void fail(std::exception_ptr e) {
+                if (!failed.exchange(true)) {
+                    error = e;
+                }
+            }
+        };
+
+        // a job without a group owns its task
+        struct Job {
+            const Range* range;
+            const Task* task;
+            std::size_t begin;
+            std::size_t end;
+            Group* group;
+        };
+
+        struct Queue {
+            std::mutex lock;
+            std::deque<Job> jobs;
+        };
+
+        // position of the calling thread in the pool:
+        // its own queue or the injection queue
+        int self() const;
+
+        void submit(int queue, const Job& job);
+        bool pop(int queue, bool back, Job& job);
+        bool try_run(int queue);
+        bool try_run_root();
+        void run(const Job& job);
+        void finish(Group& group);
+        void wait(int queue, Group& group);
+        void worker_loop(int index);
+
+        static WorkStealingPool*& current_pool() {
+            static thread_local WorkStealingPool* pool = nullptr;
+            return pool;
+        }
+
+        static int& current_index() {
+            static thread_local int index = -1;
+            return index;
+        }
+
+    private:
+
+        int workers_num;
+
+        // workers_num worker queues followed by the injection queue
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+
+        // the spawned jobs
+        Queue roots;
+
+        std::atomic<bool> stop;
+        std::atomic<std::size_t> queued;
+        std::atomic<std::size_t> roots_queued;
+
+        // idle workers wait for jobs on wake, the threads waiting
+        // for their groups wait on idle for jobs or for the groups
+        std::mutex sleep_lock;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::atomic<int> waiting;
+};
+
+// shared default executors
+inline Executor& sequential_executor() {
+    static SequentialExecutor executor;
+    return executor;
+}
+
+inline Executor& openmp_executor() {
+    static OpenMPExecutor executor;
+    return executor;
+}
+
+// runs the tasks spawned on executors without threads of their own
+inline WorkStealingPool& async_pool() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+//
+// Framework class
+//
+// Base of the skeletons: holds the executor their parallel
+// implementation runs on (OpenMP by default). A pool shared by several
+// skeletons lets one of them compute inside the other without
+// oversubscribing the machine.
+//
+// Also holds the memory resource the skeleton allocates its elements
+// from (the heap by default). The resource is to be set before the
+// skeleton grows; resources replaced later are kept alive until the
+// skeleton is destroyed, since elements allocated from them may still
+// be around.
+//
+// The asynchronous calls of the skeletons (grow_async(), compute_async())
+// are started on the executor as well, see run_async()
+//
 class Framework {
 
+    public:
+
+        void set_executor(std::shared_ptr<Executor> e) { exec = e; }
+        std::shared_ptr<Executor> get_executor() const { return exec; }
+
+        void set_memory_resource(std::shared_ptr<MemoryResource> r) {
+            if (resource != nullptr) {
+                retired.push_back(resource);
+            }
+            resource = r;
+        }
+        std::shared_ptr<MemoryResource> get_memory_resource() const { return resource; }
+
     protected:
 
-        Framework() {}
+        Framework() : exec(), resource(), retired() {}
         virtual ~Framework() {}
-     
-        template <typename RetType, typename FuncType>
-        ComputeType compute(ComputeFuncType func);
 
-        virtual void grow(size_t) = 0;
-        virtual void shrink(size_t) = 0;
+        // the sequential implementation always runs on the calling thread
+        Executor& executor(bool parallel) const {
+            if (!parallel) {
+                return sequential_executor();
+            }
+            return (exec != nullptr) ? *exec : openmp_executor();
+        }
+
+        MemoryResource& memory_resource() const {
+            return (resource != nullptr) ? *resource : heap_resource();
+        }
+
+        // runs func() on the executor (or the shared async_pool())
+        // without waiting for it; the future holds its result or
+        // exception, so the spawned task never throws
+        template <typename Func>
+        auto run_async(Func func) -> std::future<decltype(func())> {
+            using Result = decltype(func());
+            std::shared_ptr<std::packaged_task<Result()>> task = std::make_shared<std::packaged_task<Result()>>(func);
+            std::future<Result> ret = task->get_future();
+            executor(true).spawn([task]() { (*task)(); });
+            return ret;
+        }
+
+    private:
+
+        std::shared_ptr<Executor> exec;
+
+        std::shared_ptr<MemoryResource> resource;
+        std::vector<std::shared_ptr<MemoryResource>> retired;
 };
 
-}
+#include "Framework.tpp"
+
+} // namespace abstract
 
 #endif // #ifndef ABSTRACT_FRAMEWORK_H
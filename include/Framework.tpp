@@ -0,0 +1,334 @@
+
+inline void OpenMPExecutor::parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Range& body) {
+
+    if (begin >= end) {
+        return;
+    }
+
+    std::size_t n = end-begin;
+    std::size_t chunks = chunks_num(n, grain);
+
+    if (chunks <= 1) {
+        body(begin, end);
+        return;
+    }
+
+    if (omp_in_parallel()) {
+        // tasks of the enclosing team, which
+        // wait at the end of the taskloop
+        #pragma omp taskloop grainsize(1) shared(body)
+        for (std::size_t c=0; c<chunks; c++) {
+            body(chunk_begin(begin, n, chunks, c), chunk_begin(begin, n, chunks, c+1));
+        }
+    } else {
+        int threads_count = (chunks < static_cast<std::size_t>(concurrency())) ? chunks : concurrency();
+
+        #pragma omp parallel for schedule(dynamic,1) num_threads(threads_count) shared(body)
+        for (std::size_t c=0; c<chunks; c++) {
+            body(chunk_begin(begin, n, chunks, c), chunk_begin(begin, n, chunks, c+1));
+        }
+    }
+}
+
+inline void OpenMPExecutor::invoke(const std::vector<Task>& tasks) {
+
+    std::size_t n = tasks.size();
+
+    if (n == 0) {
+        return;
+    }
+
+    if (n == 1) {
+        tasks[0]();
+        return;
+    }
+
+    if (omp_in_parallel()) {
+        for (std::size_t i=0; i+1<n; i++) {
+            #pragma omp task shared(tasks) firstprivate(i)
+            tasks[i]();
+        }
+        tasks[n-1]();
+        #pragma omp taskwait
+    } else {
+        // the whole team: the tasks may invoke nested
+        // tasks onto it, e.g. recursive divisions
+        #pragma omp parallel num_threads(concurrency()) shared(tasks)
+        {
+            #pragma omp single
+            {
+                for (std::size_t i=0; i+1<n; i++) {
+                    #pragma omp task shared(tasks) firstprivate(i)
+                    tasks[i]();
+                }
+                tasks[n-1]();
+                #pragma omp taskwait
+            }
+        }
+    }
+}
+
+inline WorkStealingPool::WorkStealingPool(int threads_num)
+    : workers_num(threads_num), queues(), threads(), roots(), stop(false), queued(0), roots_queued(0), waiting(0)
+{
+    if (workers_num <= 0) {
+        workers_num = std::thread::hardware_concurrency();
+    }
+    if (workers_num <= 0) {
+        workers_num = 1;
+    }
+
+    for (int i=0; i<=workers_num; i++) {
+        queues.emplace_back(new Queue());
+    }
+
+    for (int i=0; i<workers_num; i++) {
+        threads.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+inline WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stop = true;
+    }
+    wake.notify_all();
+
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+inline int WorkStealingPool::self() const {
+    return (current_pool() == this) ? current_index() : workers_num;
+}
+
+inline void WorkStealingPool::submit(int queue, const Job& job) {
+    {
+        std::lock_guard<std::mutex> guard(queues[queue]->lock);
+        queues[queue]->jobs.push_back(job);
+    }
+    queued.fetch_add(1);
+
+    // the sleeping threads check the counter under the lock
+    { std::lock_guard<std::mutex> guard(sleep_lock); }
+    wake.notify_one();
+    if (waiting.load() > 0) {
+        idle.notify_all();
+    }
+}
+
+inline bool WorkStealingPool::pop(int queue, bool back, Job& job) {
+    std::lock_guard<std::mutex> guard(queues[queue]->lock);
+
+    std::deque<Job>& jobs = queues[queue]->jobs;
+    if (jobs.empty()) {
+        return false;
+    }
+
+    if (back) {
+        job = jobs.back();
+        jobs.pop_back();
+    } else {
+        job = jobs.front();
+        jobs.pop_front();
+    }
+    queued.fetch_sub(1);
+
+    return true;
+}
+
+inline bool WorkStealingPool::try_run(int queue) {
+
+    Job job;
+
+    if (pop(queue, true, job)) {
+        run(job);
+        return true;
+    }
+
+    // steal the oldest job of another queue
+    int queues_num = workers_num+1;
+    for (int k=1; k<queues_num; k++) {
+        if (pop((queue+k) % queues_num, false, job)) {
+            run(job);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// only the idle workers start spawned jobs
+inline bool WorkStealingPool::try_run_root() {
+
+    Job job;
+
+    {
+        std::lock_guard<std::mutex> guard(roots.lock);
+        if (roots.jobs.empty()) {
+            return false;
+        }
+        job = roots.jobs.front();
+        roots.jobs.pop_front();
+    }
+    roots_queued.fetch_sub(1);
+
+    run(job);
+    return true;
+}
+
+inline void WorkStealingPool::run(const Job& job) {
+
+    if (job.group == nullptr) {
+        // a spawned task reports its errors on its own
+        std::unique_ptr<const Task> task(job.task);
+        (*task)();
+        return;
+    }
+
+    // the jobs of a failed call are skipped
+    if (!job.group->failed.load()) {
+        try {
+            if (job.range != nullptr) {
+                (*job.range)(job.begin, job.end);
+            } else {
+                (*job.task)();
+            }
+        } catch (...) {
+            job.group->fail(std::current_exception());
+        }
+    }
+
+    finish(*job.group);
+}
+
+inline void WorkStealingPool::finish(Group& group) {
+    // the group may be gone as soon as its last job is counted
+    if (group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        { std::lock_guard<std::mutex> guard(sleep_lock); }
+        idle.notify_all();
+    }
+}
+
+inline void WorkStealingPool::wait(int queue, Group& group) {
+
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        if (try_run(queue)) {
+            continue;
+        }
+
+        // nothing to steal: sleep until a job is queued
+        // or the last job of the group is done
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        waiting.fetch_add(1);
+        idle.wait(guard, [this, &group]() {
+            return group.pending.load(std::memory_order_acquire) == 0 || queued.load() > 0;
+        });
+        waiting.fetch_sub(1);
+    }
+
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
+
+inline void WorkStealingPool::worker_loop(int index) {
+
+    current_pool() = this;
+    current_index() = index;
+
+    while (true) {
+        if (try_run(index) || try_run_root()) {
+            continue;
+        }
+
+        // the spawned jobs are drained before stopping
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this]() { return stop || queued.load() > 0 || roots_queued.load() > 0; });
+
+        if (stop && queued.load() == 0 && roots_queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+inline void WorkStealingPool::parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Range& body) {
+
+    if (begin >= end) {
+        return;
+    }
+
+    std::size_t n = end-begin;
+    std::size_t chunks = chunks_num(n, grain);
+
+    if (chunks <= 1) {
+        body(begin, end);
+        return;
+    }
+
+    int queue = self();
+
+    Group group(chunks-1);
+
+    // the calling thread keeps the first chunk
+    for (std::size_t c=chunks-1; c>=1; c--) {
+        Job job = { &body, nullptr, chunk_begin(begin, n, chunks, c), chunk_begin(begin, n, chunks, c+1), &group };
+        submit(queue, job);
+    }
+
+    // the queued jobs refer to the group and the body,
+    // so they are waited for whatever the chunk does
+    try {
+        body(chunk_begin(begin, n, chunks, 0), chunk_begin(begin, n, chunks, 1));
+    } catch (...) {
+        group.fail(std::current_exception());
+    }
+
+    wait(queue, group);
+}
+
+inline void WorkStealingPool::invoke(const std::vector<Task>& tasks) {
+
+    std::size_t n = tasks.size();
+
+    if (n == 0) {
+        return;
+    }
+
+    int queue = self();
+
+    Group group(n-1);
+
+    for (std::size_t i=0; i+1<n; i++) {
+        Job job = { nullptr, &tasks[i], 0, 0, &group };
+        submit(queue, job);
+    }
+
+    try {
+        tasks[n-1]();
+    } catch (...) {
+        group.fail(std::current_exception());
+    }
+
+    wait(queue, group);
+}
+
+inline void WorkStealingPool::spawn(Task task) {
+    Job job = { nullptr, new Task(std::move(task)), 0, 0, nullptr };
+    {
+        std::lock_guard<std::mutex> guard(roots.lock);
+        roots.jobs.push_back(job);
+    }
+    roots_queued.fetch_add(1);
+
+    // the waiters of idle never take root jobs, only the workers
+    { std::lock_guard<std::mutex> guard(sleep_lock); }
+    wake.notify_one();
+}
+
+inline void Executor::spawn(Task task) {
+    async_pool().spawn(std::move(task));
+}
+
+// end
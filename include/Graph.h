@@ -0,0 +1,234 @@
+#ifndef ABSTRACT_GRAPH_H
+#define ABSTRACT_GRAPH_H
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <cmath>
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <type_traits>
+#include <omp.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace abstract {
+
+//
+// Graph class
+//
+// Directed graph in the compressed sparse row (CSR) format: the edges
+// leaving node i are the contiguous range [offsets[i], offsets[i+1]) of
+// the targets and edge data arrays, sorted by target. A transposed copy
+// of the structure (incoming edges) serves the pull-based kernels.
+//
+// Nodes are numbered by their indices in the node store. Edges added
+// with add_edge() are buffered and compacted into the CSR arrays by
+// build(); adding an edge which already exists replaces its data.
+// Large graphs are loaded in bulk from edge list files with
+// load_edge_list()
+//
+template <typename NodeType, typename EdgeType>
+class Graph {
+
+    public:
+
+        using node_iterator = typename std::vector<NodeType>::iterator;
+
+        // edge list file formats:
+        //
+        // text   - one edge per line: "from to [edge]", node indices up
+        //          to INT_MAX; arithmetic edge data is parsed in place,
+        //          other types are read with operator>>; empty lines and
+        //          lines starting with '#' or '%' are skipped
+        // binary - array of EdgeRecord structures, read through mmap()
+        enum class EdgeListFormat {
+            text = 0,
+            binary
+        };
+
+        struct EdgeRecord {
+            int32_t from;
+            int32_t to;
+            EdgeType edge;
+        };
+
+        // contiguous range of a node's neighbours or edges
+        template <typename T>
+        class Range {
+            public:
+                Range(T* first, T* last) : first(first), last(last) {}
+                T* begin() const { return first; }
+                T* end() const { return last; }
+                std::size_t size() const { return last-first; }
+                T& operator[](std::size_t i) const { return first[i]; }
+            private:
+                T* first;
+                T* last;
+        };
+
+        Graph(std::size_t size = 0);
+        ~Graph() {}
+
+        node_iterator node_begin() { return nodes.begin(); }
+        node_iterator node_end() { return nodes.end(); }
+
+        std::size_t node_size() const { return nodes.size(); }
+        std::size_t edge_size() const { return targets.size(); }
+
+        // the node store grows to hold node_index
+        void add_node(int node_index, NodeType node);
+        NodeType& node(int node_index) { return nodes[node_index]; }
+
+        void add_edge(std::pair<int,int> from_to_index_pair, EdgeType edge);
+
+        // compact the edges added since the last build()
+        // into the CSR arrays
+        Graph<NodeType,EdgeType>& build();
+
+        // replace all the edges of the graph with the edges of the file;
+        // the node store grows to hold the referenced nodes. Without
+        // sort_and_dedup adjacency lists keep an arbitrary order and
+        // duplicate edges, which saves the sorting pass
+        Graph<NodeType,EdgeType>& load_edge_list(const std::string& path,
+                                                 EdgeListFormat format = EdgeListFormat::text,
+                                                 bool sort_and_dedup = true);
+
+        // binary search in the adjacency of the source node (linear
+        // search if it is not sorted); returns invalid_edge if there
+        // is no such edge
+        EdgeType& find_edge(const std::pair<int,int>& edge);
+
+        std::size_t out_degree(int node_index) const { return offsets[node_index+1]-offsets[node_index]; }
+        std::size_t in_degree(int node_index) const { return in_offsets[node_index+1]-in_offsets[node_index]; }
+
+        Range<const int> out_neighbors(int node_index) const {
+            return Range<const int>(targets.data()+offsets[node_index], targets.data()+offsets[node_index+1]);
+        }
+
+        Range<const int> in_neighbors(int node_index) const {
+            return Range<const int>(sources.data()+in_offsets[node_index], sources.data()+in_offsets[node_index+1]);
+        }
+
+        Range<EdgeType> out_edges(int node_index) {
+            return Range<EdgeType>(edges.data()+offsets[node_index], edges.data()+offsets[node_index+1]);
+        }
+
+        //
+        // parallel graph kernels
+        //
+
+        // direction-optimizing breadth-first search (Beamer et al.):
+        // switches between top-down steps over the frontier and
+        // bottom-up steps over the unvisited nodes; returns the depth
+        // of every node, -1 for the unreachable ones
+        std::vector<int> bfs(int source) const;
+
+        // connected components of the underlying undirected graph
+        // (Shiloach-Vishkin hooking and pointer jumping); every node is
+        // labelled with the smallest node index of its component
+        std::vector<int> connected_components() const;
+
+        // pull-based PageRank; the rank of dangling nodes is spread
+        // uniformly over all the nodes
+        std::vector<double> pagerank(double damping = 0.85, int max_iterations = 100, double tolerance = 1e-6) const;
+
+        void print_nodes(std::ostream& outs) {
+            for (std::size_t i = 0; i < nodes.size(); i++) {
+                outs << "node[" << i << "] = { " << nodes[i] << " }" << std::endl;
+            }
+        }
+
+    public:
+
+        static EdgeType invalid_edge;
+
+    private:
+
+        // edge list views consumed by assemble()
+        class VectorEdgeList {
+            public:
+                VectorEdgeList(const std::vector<std::pair<int,int>>& pairs, const std::vector<EdgeType>& data)
+                    : pairs(pairs), data(data) {}
+                std::size_t size() const { return pairs.size(); }
+                int from(std::size_t i) const { return pairs[i].first; }
+                int to(std::size_t i) const { return pairs[i].second; }
+                const EdgeType& edge(std::size_t i) const { return data[i]; }
+            private:
+                const std::vector<std::pair<int,int>>& pairs;
+                const std::vector<EdgeType>& data;
+        };
+
+        class RecordEdgeList {
+            public:
+                RecordEdgeList(const EdgeRecord* records, std::size_t count)
+                    : records(records), count(count) {}
+                std::size_t size() const { return count; }
+                int from(std::size_t i) const { return records[i].from; }
+                int to(std::size_t i) const { return records[i].to; }
+                const EdgeType& edge(std::size_t i) const { return records[i].edge; }
+            private:
+                const EdgeRecord* records;
+                std::size_t count;
+        };
+
+        // parallel CSR construction: atomic degree counts, prefix sum,
+        // scatter of edge ids and an optional per-node sort by target
+        // dropping duplicates (the edge coming last in the list wins)
+        template <typename EdgeList>
+        void assemble(const EdgeList& list, bool sort_and_dedup);
+
+        // rebuild the incoming edges from the outgoing ones
+        void build_transpose();
+
+        void parse_edge_list(const char* text, std::size_t bytes,
+                             std::vector<std::pair<int,int>>& pairs,
+                             std::vector<EdgeType>& data);
+
+        // parses the edge data of a text line in [first, last)
+        static bool parse_edge(const char* first, const char* last, EdgeType& edge, std::true_type is_arithmetic);
+        static bool parse_edge(const char* first, const char* last, EdgeType& edge, std::false_type is_arithmetic);
+
+        // parallel in-place exclusive prefix sum; returns the total
+        static std::size_t prefix_sum(std::vector<std::size_t>& counts);
+
+        static const char* map_file(const std::string& path, std::size_t& bytes);
+
+    private:
+
+        std::vector<NodeType> nodes; // graph nodes are numbered as vector indecies
+
+        // outgoing edges
+        std::vector<std::size_t> offsets;
+        std::vector<int> targets;
+        std::vector<EdgeType> edges;
+
+        // incoming edges
+        std::vector<std::size_t> in_offsets;
+        std::vector<int> sources;
+
+        // adjacency lists are sorted by target
+        bool sorted;
+
+        // edges added since the last build()
+        std::vector<std::pair<int,int>> pending;
+        std::vector<EdgeType> pending_edges;
+};
+
+template <typename NodeType,typename EdgeType>
+EdgeType Graph<NodeType,EdgeType>::invalid_edge = EdgeType();
+
+#include "Graph.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_GRAPH_H
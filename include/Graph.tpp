@@ -0,0 +1,656 @@
+
+template <typename NodeType, typename EdgeType>
+Graph<NodeType,EdgeType>::Graph(std::size_t size)
+    : nodes(size), offsets(size+1, 0), targets(), edges(),
+      in_offsets(size+1, 0), sources(), sorted(true), pending(), pending_edges() {}
+
+template <typename NodeType, typename EdgeType>
+void Graph<NodeType,EdgeType>::add_node(int node_index, NodeType node) {
+    if (node_index < 0) {
+        std::cerr << "Graph::add_node(): error: node index cannot be negative";
+        std::exit(EXIT_FAILURE);
+    }
+    if (static_cast<std::size_t>(node_index) >= nodes.size()) {
+        // new nodes have no edges yet
+        nodes.resize(node_index+1);
+        offsets.resize(node_index+2, offsets.back());
+        in_offsets.resize(node_index+2, in_offsets.back());
+    }
+    nodes[node_index] = node;
+}
+
+template <typename NodeType, typename EdgeType>
+void Graph<NodeType,EdgeType>::add_edge(std::pair<int,int> from_to_index_pair, EdgeType edge) {
+    if (from_to_index_pair.first < 0 || from_to_index_pair.second < 0) {
+        std::cerr << "Graph::add_edge(): error: node index cannot be negative";
+        std::exit(EXIT_FAILURE);
+    }
+    pending.push_back(from_to_index_pair);
+    pending_edges.push_back(edge);
+}
+
+template <typename NodeType, typename EdgeType>
+Graph<NodeType,EdgeType>& Graph<NodeType,EdgeType>::build() {
+
+    if (pending.empty()) {
+        return *this;
+    }
+
+    std::size_t m_old = targets.size();
+
+    if (m_old > 0) {
+        // existing edges go first, so that the new ones replace them
+        std::size_t n = nodes.size();
+        std::vector<std::pair<int,int>> all(m_old+pending.size());
+        std::vector<EdgeType> all_edges(m_old+pending.size());
+
+        #pragma omp parallel for schedule(dynamic,64)
+        for (std::size_t u=0; u<n; u++) {
+            for (std::size_t e=offsets[u]; e<offsets[u+1]; e++) {
+                all[e] = std::make_pair(static_cast<int>(u), targets[e]);
+                all_edges[e] = edges[e];
+            }
+        }
+
+        std::copy(pending.begin(), pending.end(), all.begin()+m_old);
+        std::copy(pending_edges.begin(), pending_edges.end(), all_edges.begin()+m_old);
+
+        pending.swap(all);
+        pending_edges.swap(all_edges);
+    }
+
+    assemble(VectorEdgeList(pending, pending_edges), true);
+
+    pending.clear();
+    pending_edges.clear();
+
+    return *this;
+}
+
+template <typename NodeType, typename EdgeType>
+Graph<NodeType,EdgeType>& Graph<NodeType,EdgeType>::load_edge_list(const std::string& path,
+                                                                   EdgeListFormat format,
+                                                                   bool sort_and_dedup) {
+    pending.clear();
+    pending_edges.clear();
+
+    std::size_t bytes = 0;
+    const char* addr = map_file(path, bytes);
+
+    if (format == EdgeListFormat::binary) {
+        if (!std::is_trivially_copyable<EdgeType>::value) {
+            std::cerr << "Graph::load_edge_list(): error: binary edge lists need a trivially copyable edge type";
+            std::exit(EXIT_FAILURE);
+        }
+
+        if (bytes % sizeof(EdgeRecord) != 0) {
+            std::cerr << "Graph::load_edge_list(): error: the size of the file " << path << " is not a multiple of the edge record size";
+            std::exit(EXIT_FAILURE);
+        }
+
+        // edges are read straight from the mapping
+        assemble(RecordEdgeList(reinterpret_cast<const EdgeRecord*>(addr), bytes/sizeof(EdgeRecord)), sort_and_dedup);
+    } else {
+        std::vector<std::pair<int,int>> pairs;
+        std::vector<EdgeType> data;
+        parse_edge_list(addr, bytes, pairs, data);
+        assemble(VectorEdgeList(pairs, data), sort_and_dedup);
+    }
+
+    if (addr != nullptr) {
+        munmap(const_cast<char*>(addr), bytes);
+    }
+
+    return *this;
+}
+
+template <typename NodeType, typename EdgeType>
+template <typename EdgeList>
+void Graph<NodeType,EdgeType>::assemble(const EdgeList& list, bool sort_and_dedup) {
+
+    std::size_t m = list.size();
+
+    int min_index = 0;
+    int max_index = -1;
+
+    #pragma omp parallel for reduction(min:min_index) reduction(max:max_index)
+    for (std::size_t i=0; i<m; i++) {
+        min_index = std::min(min_index, std::min(list.from(i), list.to(i)));
+        max_index = std::max(max_index, std::max(list.from(i), list.to(i)));
+    }
+
+    if (min_index < 0) {
+        std::cerr << "Graph::assemble(): error: node index cannot be negative";
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (static_cast<std::size_t>(max_index+1) > nodes.size()) {
+        nodes.resize(max_index+1);
+    }
+
+    std::size_t n = nodes.size();
+
+    // out-degrees, turned into row offsets
+    std::vector<std::size_t> rows(n+1, 0);
+
+    #pragma omp parallel for
+    for (std::size_t i=0; i<m; i++) {
+        __sync_fetch_and_add(&rows[list.from(i)], 1);
+    }
+
+    prefix_sum(rows);
+
+    // scatter edge ids into their rows
+    std::vector<std::size_t> order(m);
+    std::vector<std::size_t> cursor(rows.begin(), rows.end()-1);
+
+    #pragma omp parallel for
+    for (std::size_t i=0; i<m; i++) {
+        order[__sync_fetch_and_add(&cursor[list.from(i)], 1)] = i;
+    }
+
+    if (sort_and_dedup) {
+        // sort every row by target and edge id, so that the last one
+        // of the duplicate edges is kept
+        std::vector<std::size_t> row_sizes(n+1, 0);
+
+        #pragma omp parallel for schedule(dynamic,64)
+        for (std::size_t u=0; u<n; u++) {
+            auto first = order.begin()+rows[u];
+            auto last = order.begin()+rows[u+1];
+
+            std::sort(first, last, [&list](std::size_t a, std::size_t b) {
+                          return (list.to(a) < list.to(b)) || (list.to(a) == list.to(b) && a < b);
+                      });
+
+            auto out = first;
+            for (auto it=first; it!=last; ++it) {
+                if (it+1 != last && list.to(*(it+1)) == list.to(*it)) {
+                    continue;
+                }
+                *out++ = *it;
+            }
+            row_sizes[u] = out-first;
+        }
+
+        offsets = row_sizes;
+        prefix_sum(offsets);
+    } else {
+        offsets = rows;
+    }
+
+    targets.resize(offsets[n]);
+    edges.resize(offsets[n]);
+
+    #pragma omp parallel for schedule(dynamic,64)
+    for (std::size_t u=0; u<n; u++) {
+        std::size_t from = rows[u];
+        for (std::size_t e=offsets[u]; e<offsets[u+1]; e++, from++) {
+            targets[e] = list.to(order[from]);
+            edges[e] = list.edge(order[from]);
+        }
+    }
+
+    sorted = sort_and_dedup;
+
+    build_transpose();
+}
+
+template <typename NodeType, typename EdgeType>
+void Graph<NodeType,EdgeType>::build_transpose() {
+
+    std::size_t n = nodes.size();
+    std::size_t m = targets.size();
+
+    in_offsets.assign(n+1, 0);
+
+    #pragma omp parallel for
+    for (std::size_t e=0; e<m; e++) {
+        __sync_fetch_and_add(&in_offsets[targets[e]], 1);
+    }
+
+    prefix_sum(in_offsets);
+
+    sources.resize(m);
+    std::vector<std::size_t> cursor(in_offsets.begin(), in_offsets.end()-1);
+
+    #pragma omp parallel for schedule(dynamic,64)
+    for (std::size_t u=0; u<n; u++) {
+        for (std::size_t e=offsets[u]; e<offsets[u+1]; e++) {
+            sources[__sync_fetch_and_add(&cursor[targets[e]], 1)] = u;
+        }
+    }
+
+    // the scatter leaves incoming edges in arbitrary order
+    #pragma omp parallel for schedule(dynamic,64)
+    for (std::size_t v=0; v<n; v++) {
+        std::sort(sources.begin()+in_offsets[v], sources.begin()+in_offsets[v+1]);
+    }
+}
+
+template <typename NodeType, typename EdgeType>
+void Graph<NodeType,EdgeType>::parse_edge_list(const char* text, std::size_t bytes,
+                                               std::vector<std::pair<int,int>>& pairs,
+                                               std::vector<EdgeType>& data) {
+
+    int chunks = omp_get_max_threads();
+
+    // chunk boundaries are moved to the line starts
+    std::vector<std::size_t> bounds(chunks+1, bytes);
+    bounds[0] = 0;
+    for (int c=1; c<chunks; c++) {
+        std::size_t pos = std::max(bounds[c-1], bytes*c/chunks);
+        while (pos > 0 && pos < bytes && text[pos-1] != '\n') {
+            pos++;
+        }
+        bounds[c] = pos;
+    }
+
+    std::vector<std::vector<std::pair<int,int>>> chunk_pairs(chunks);
+    std::vector<std::vector<EdgeType>> chunk_data(chunks);
+
+    bool malformed = false;
+
+    #pragma omp parallel for schedule(static,1) reduction(||:malformed)
+    for (int c=0; c<chunks; c++) {
+        const char* p = text+bounds[c];
+        const char* end = text+bounds[c+1];
+
+        auto skip_blanks = [&p, end]() {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+                p++;
+            }
+        };
+
+        auto parse_index = [&p, end](int& value) {
+            const char* start = p;
+            value = 0;
+            while (p < end && *p >= '0' && *p <= '9') {
+                int digit = *p-'0';
+                if (value > (INT_MAX-digit)/10) {
+                    return false;
+                }
+                value = 10*value+digit;
+                p++;
+            }
+            return p != start;
+        };
+
+        while (p < end) {
+            const char* eol = p;
+            while (eol < end && *eol != '\n') {
+                eol++;
+            }
+
+            skip_blanks();
+            if (p == eol || *p == '#' || *p == '%') {
+                p = eol+1;
+                continue;
+            }
+
+            int from, to;
+            bool ok = parse_index(from);
+            skip_blanks();
+            ok = ok && parse_index(to);
+            skip_blanks();
+
+            if (!ok) {
+                malformed = true;
+                break;
+            }
+
+            EdgeType edge = EdgeType();
+            if (p < eol && !parse_edge(p, eol, edge, std::is_arithmetic<EdgeType>())) {
+                malformed = true;
+                break;
+            }
+
+            chunk_pairs[c].push_back(std::make_pair(from, to));
+            chunk_data[c].push_back(edge);
+
+            p = eol+1;
+        }
+    }
+
+    if (malformed) {
+        std::cerr << "Graph::load_edge_list(): error: malformed edge list line or node index out of range";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // concatenate the chunks in file order
+    std::vector<std::size_t> chunk_offsets(chunks+1, 0);
+    for (int c=0; c<chunks; c++) {
+        chunk_offsets[c+1] = chunk_offsets[c]+chunk_pairs[c].size();
+    }
+
+    pairs.resize(chunk_offsets[chunks]);
+    data.resize(chunk_offsets[chunks]);
+
+    #pragma omp parallel for schedule(static,1)
+    for (int c=0; c<chunks; c++) {
+        std::copy(chunk_pairs[c].begin(), chunk_pairs[c].end(), pairs.begin()+chunk_offsets[c]);
+        std::copy(chunk_data[c].begin(), chunk_data[c].end(), data.begin()+chunk_offsets[c]);
+    }
+}
+
+template <typename NodeType, typename EdgeType>
+bool Graph<NodeType,EdgeType>::parse_edge(const char* first, const char* last, EdgeType& edge, std::true_type) {
+
+    // a copy on the stack terminates the field for strto*()
+    char field[64];
+    std::size_t length = std::min(static_cast<std::size_t>(last-first), sizeof(field)-1);
+    std::memcpy(field, first, length);
+    field[length] = '\0';
+
+    char* stop = field;
+    if (std::is_floating_point<EdgeType>::value) {
+        edge = static_cast<EdgeType>(std::strtod(field, &stop));
+    } else if (std::is_signed<EdgeType>::value) {
+        edge = static_cast<EdgeType>(std::strtoll(field, &stop, 10));
+    } else {
+        edge = static_cast<EdgeType>(std::strtoull(field, &stop, 10));
+    }
+
+    return stop != field;
+}
+
+template <typename NodeType, typename EdgeType>
+bool Graph<NodeType,EdgeType>::parse_edge(const char* first, const char* last, EdgeType& edge, std::false_type) {
+    std::istringstream fields(std::string(first, last));
+    fields >> edge;
+    return true;
+}
+
+template <typename NodeType, typename EdgeType>
+std::size_t Graph<NodeType,EdgeType>::prefix_sum(std::vector<std::size_t>& counts) {
+
+    std::size_t n = counts.size();
+    int blocks = std::max(1, std::min(omp_get_max_threads(), static_cast<int>(n/4096)));
+    std::vector<std::size_t> block_sums(blocks+1, 0);
+
+    // block sums, their scan, then a local scan of every block
+    #pragma omp parallel for schedule(static,1)
+    for (int b=0; b<blocks; b++) {
+        std::size_t sum = 0;
+        for (std::size_t i=n*b/blocks; i<n*(b+1)/blocks; i++) {
+            sum += counts[i];
+        }
+        block_sums[b+1] = sum;
+    }
+
+    for (int b=0; b<blocks; b++) {
+        block_sums[b+1] += block_sums[b];
+    }
+
+    #pragma omp parallel for schedule(static,1)
+    for (int b=0; b<blocks; b++) {
+        std::size_t sum = block_sums[b];
+        for (std::size_t i=n*b/blocks; i<n*(b+1)/blocks; i++) {
+            std::size_t count = counts[i];
+            counts[i] = sum;
+            sum += count;
+        }
+    }
+
+    return block_sums[blocks];
+}
+
+template <typename NodeType, typename EdgeType>
+const char* Graph<NodeType,EdgeType>::map_file(const std::string& path, std::size_t& bytes) {
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Graph::load_edge_list(): error: cannot open the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Graph::load_edge_list(): error: cannot stat the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    bytes = st.st_size;
+    if (bytes == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        std::cerr << "Graph::load_edge_list(): error: cannot map the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    madvise(addr, bytes, MADV_SEQUENTIAL);
+
+    return static_cast<const char*>(addr);
+}
+
+template <typename NodeType, typename EdgeType>
+EdgeType& Graph<NodeType,EdgeType>::find_edge(const std::pair<int,int>& edge) {
+
+    if (edge.first < 0 || static_cast<std::size_t>(edge.first) >= nodes.size()) {
+        return invalid_edge;
+    }
+
+    auto first = targets.begin()+offsets[edge.first];
+    auto last = targets.begin()+offsets[edge.first+1];
+    auto it = sorted ? std::lower_bound(first, last, edge.second)
+                     : std::find(first, last, edge.second);
+
+    if (it != last && *it == edge.second) {
+        return edges[it-targets.begin()];
+    } else {
+        return invalid_edge;
+    }
+}
+
+template <typename NodeType, typename EdgeType>
+std::vector<int> Graph<NodeType,EdgeType>::bfs(int source) const {
+
+    // switching heuristics of the direction-optimizing BFS
+    const std::size_t alpha = 15;
+    const std::size_t beta = 18;
+
+    std::size_t n = nodes.size();
+    std::vector<int> depth(n, -1);
+
+    if (source < 0 || static_cast<std::size_t>(source) >= n) {
+        std::cerr << "Graph::bfs(): error: invalid source node";
+        std::exit(EXIT_FAILURE);
+    }
+
+    depth[source] = 0;
+    std::vector<int> frontier(1, source);
+
+    // edges left to be explored and edges leaving the frontier
+    std::size_t edges_to_check = targets.size();
+    std::size_t scout_count = out_degree(source);
+    int level = 0;
+
+    while (!frontier.empty()) {
+
+        if (scout_count > edges_to_check/alpha) {
+
+            //
+            // BOTTOM-UP STEPS
+            //
+            // every unvisited node looks for a parent in the frontier
+            // among its incoming edges and stops at the first one
+            //
+            std::vector<char> in_frontier(n, 0);
+            for (int u : frontier) {
+                in_frontier[u] = 1;
+            }
+
+            std::size_t awake_count = frontier.size();
+            std::size_t old_awake_count;
+
+            do {
+                old_awake_count = awake_count;
+                awake_count = 0;
+                std::vector<char> next(n, 0);
+
+                #pragma omp parallel for schedule(dynamic,1024) reduction(+:awake_count)
+                for (std::size_t v=0; v<n; v++) {
+                    if (depth[v] < 0) {
+                        for (std::size_t e=in_offsets[v]; e<in_offsets[v+1]; e++) {
+                            if (in_frontier[sources[e]]) {
+                                depth[v] = level+1;
+                                next[v] = 1;
+                                awake_count++;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                in_frontier.swap(next);
+                level++;
+            } while ((awake_count >= old_awake_count) || (awake_count > n/beta));
+
+            // back to a frontier queue
+            frontier.clear();
+            for (std::size_t v=0; v<n; v++) {
+                if (in_frontier[v]) {
+                    frontier.push_back(v);
+                }
+            }
+            scout_count = 1;
+
+        } else {
+
+            //
+            // TOP-DOWN STEP
+            //
+            // the frontier claims its unvisited neighbours; thread-local
+            // queues are concatenated into the next frontier
+            //
+            edges_to_check -= (scout_count < edges_to_check) ? scout_count : edges_to_check;
+            scout_count = 0;
+
+            std::vector<int> next;
+
+            #pragma omp parallel reduction(+:scout_count)
+            {
+                std::vector<int> local;
+
+                #pragma omp for schedule(dynamic,64) nowait
+                for (std::size_t f=0; f<frontier.size(); f++) {
+                    int u = frontier[f];
+                    for (std::size_t e=offsets[u]; e<offsets[u+1]; e++) {
+                        int v = targets[e];
+                        if (depth[v] < 0 && __sync_bool_compare_and_swap(&depth[v], -1, level+1)) {
+                            local.push_back(v);
+                            scout_count += out_degree(v);
+                        }
+                    }
+                }
+
+                #pragma omp critical
+                next.insert(next.end(), local.begin(), local.end());
+            }
+
+            frontier.swap(next);
+            level++;
+        }
+    }
+
+    return depth;
+}
+
+template <typename NodeType, typename EdgeType>
+std::vector<int> Graph<NodeType,EdgeType>::connected_components() const {
+
+    std::size_t n = nodes.size();
+    std::vector<int> comp(n);
+
+    #pragma omp parallel for
+    for (std::size_t v=0; v<n; v++) {
+        comp[v] = v;
+    }
+
+    bool change = true;
+    while (change) {
+        change = false;
+
+        // hook the root of the larger label under the smaller label
+        #pragma omp parallel for schedule(dynamic,64) reduction(||:change)
+        for (std::size_t u=0; u<n; u++) {
+            for (std::size_t e=offsets[u]; e<offsets[u+1]; e++) {
+                int v = targets[e];
+                int comp_u = comp[u];
+                int comp_v = comp[v];
+                if (comp_u == comp_v) {
+                    continue;
+                }
+                int high = std::max(comp_u, comp_v);
+                int low = std::min(comp_u, comp_v);
+                if (comp[high] == high && __sync_bool_compare_and_swap(&comp[high], high, low)) {
+                    change = true;
+                }
+            }
+        }
+
+        // pointer jumping flattens the trees
+        #pragma omp parallel for
+        for (std::size_t v=0; v<n; v++) {
+            while (comp[v] != comp[comp[v]]) {
+                comp[v] = comp[comp[v]];
+            }
+        }
+    }
+
+    return comp;
+}
+
+template <typename NodeType, typename EdgeType>
+std::vector<double> Graph<NodeType,EdgeType>::pagerank(double damping, int max_iterations, double tolerance) const {
+
+    std::size_t n = nodes.size();
+    std::vector<double> rank(n, (n > 0) ? 1.0/n : 0.0);
+    std::vector<double> contrib(n);
+
+    for (int iter=0; iter<max_iterations; iter++) {
+
+        // outgoing contributions and the rank of dangling nodes
+        double dangling = 0.0;
+
+        #pragma omp parallel for reduction(+:dangling)
+        for (std::size_t u=0; u<n; u++) {
+            std::size_t degree = offsets[u+1]-offsets[u];
+            if (degree > 0) {
+                contrib[u] = rank[u]/degree;
+            } else {
+                contrib[u] = 0.0;
+                dangling += rank[u];
+            }
+        }
+
+        double base = (1.0-damping)/n+damping*dangling/n;
+        double error = 0.0;
+
+        // every node pulls the contributions of its in-neighbours
+        #pragma omp parallel for schedule(dynamic,256) reduction(+:error)
+        for (std::size_t v=0; v<n; v++) {
+            double sum = 0.0;
+            for (std::size_t e=in_offsets[v]; e<in_offsets[v+1]; e++) {
+                sum += contrib[sources[e]];
+            }
+            double new_rank = base+damping*sum;
+            error += std::fabs(new_rank-rank[v]);
+            rank[v] = new_rank;
+        }
+
+        if (error < tolerance) {
+            break;
+        }
+    }
+
+    return rank;
+}
+
+// end
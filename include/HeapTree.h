@@ -0,0 +1,70 @@
+#ifndef ABSTRACT_HEAP_TREE_H
+#define ABSTRACT_HEAP_TREE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Framework.h"
+
+namespace abstract {
+
+//
+// HeapTree class
+//
+// Tiled computation of complete Arity-ary trees laid out as heaps:
+// the root at index 0, the children of the element i at the indices
+// [Arity*i+1, Arity*i+Arity]. Shared by the balanced fractals, which
+// differ only in where they keep the element of an index.
+//
+// Instead of a parallel loop (and a barrier) per depth, every thread
+// computes whole subtrees depth-first, keeping their elements in its
+// own cache; the subtrees are rooted at the shallowest depth with at
+// least as many elements as threads. The few elements above them are
+// finished by the calling thread.
+//
+// element_func(index, d, child_rets) computes the element of the index
+// (at depth d) from the results of its children, empty for the leaves
+//
+template <int Arity>
+class HeapTree {
+
+    public:
+
+        static std::size_t first_child(std::size_t index) { return Arity*index+1; }
+
+        // index of the first element of depth d
+        static std::size_t depth_start(int d);
+
+        // the shallowest depth (at most depth) with
+        // at least threads_num elements
+        static int tile_depth(int depth, std::size_t threads_num);
+
+        // result of the root of a tree of the given depth
+        template <typename ComputeType, typename ElementFunc>
+        static ComputeType compute(Executor& executor, int depth, ElementFunc& element_func);
+
+        // results of the subtrees rooted at the elements [lo, hi) of depth d
+        template <typename ComputeType, typename ElementFunc>
+        static std::vector<ComputeType> compute_subtrees(Executor& executor, int depth, int d, std::size_t lo, std::size_t hi,
+                                                         ElementFunc& element_func);
+
+        // result of the root given the results of
+        // all the elements of depth d
+        template <typename ComputeType, typename ElementFunc>
+        static ComputeType compute_above(int d, const std::vector<ComputeType>& rets, ElementFunc& element_func);
+
+    private:
+
+        // depth-first computation of the subtree rooted at the element
+        // index (at depth d); child results are collected into the
+        // per-depth buffers of the calling thread
+        template <typename ComputeType, typename ElementFunc>
+        static ComputeType compute_subtree(int depth, std::size_t index, int d, ElementFunc& element_func,
+                                           std::vector<std::vector<ComputeType>>& child_rets);
+};
+
+#include "HeapTree.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_HEAP_TREE_H
@@ -0,0 +1,106 @@
+
+template <int Arity>
+std::size_t HeapTree<Arity>::depth_start(int d) {
+    std::size_t start = 0;
+    std::size_t depth_size = 1;
+    for (int k = 0; k < d; k++) {
+        start += depth_size;
+        depth_size *= Arity;
+    }
+    return start;
+}
+
+template <int Arity>
+int HeapTree<Arity>::tile_depth(int depth, std::size_t threads_num) {
+    int d = 0;
+    std::size_t depth_size = 1;
+    while (d < depth && depth_size < threads_num) {
+        d++;
+        depth_size *= Arity;
+    }
+    return d;
+}
+
+template <int Arity>
+template <typename ComputeType, typename ElementFunc>
+ComputeType HeapTree<Arity>::compute(Executor& executor, int depth, ElementFunc& element_func) {
+
+    int d = tile_depth(depth, executor.concurrency());
+
+    std::vector<ComputeType> tile_rets = compute_subtrees<ComputeType>(executor, depth, d, depth_start(d), depth_start(d+1),
+                                                                       element_func);
+
+    return compute_above<ComputeType>(d, tile_rets, element_func);
+}
+
+template <int Arity>
+template <typename ComputeType, typename ElementFunc>
+std::vector<ComputeType> HeapTree<Arity>::compute_subtrees(Executor& executor, int depth, int d, std::size_t lo, std::size_t hi,
+                                                           ElementFunc& element_func) {
+
+    std::vector<ComputeType> rets(hi-lo);
+
+    executor.parallel_for(lo, hi, 1, [&](std::size_t begin, std::size_t end) {
+        std::vector<std::vector<ComputeType>> child_rets(depth+1);
+        for (std::size_t i = begin; i < end; i++) {
+            rets[i-lo] = compute_subtree<ComputeType>(depth, i, d, element_func, child_rets);
+        }
+    });
+
+    return rets;
+}
+
+template <int Arity>
+template <typename ComputeType, typename ElementFunc>
+ComputeType HeapTree<Arity>::compute_above(int d, const std::vector<ComputeType>& rets, ElementFunc& element_func) {
+
+    std::size_t start = depth_start(d);
+
+    if (start == 0) {
+        return rets[0];
+    }
+
+    std::vector<ComputeType> computed_rets(start);
+    std::vector<ComputeType> ret_vals(Arity);
+
+    // the elements of depth d-1 start at (start-1)/Arity
+    int parent_depth = d-1;
+    std::size_t parent_start = (start-1)/Arity;
+
+    for (std::size_t i = start; i-- > 0; ) {
+        if (i < parent_start) {
+            parent_depth--;
+            parent_start = (parent_start-1)/Arity;
+        }
+        // get child computation results
+        std::size_t first = first_child(i);
+        for (std::size_t j = first; j < first+Arity; j++) {
+            ret_vals[j-first] = (j >= start) ? rets[j-start] : computed_rets[j];
+        }
+        computed_rets[i] = element_func(i, parent_depth, ret_vals);
+    }
+
+    return computed_rets[0];
+}
+
+template <int Arity>
+template <typename ComputeType, typename ElementFunc>
+ComputeType HeapTree<Arity>::compute_subtree(int depth, std::size_t index, int d, ElementFunc& element_func,
+                                             std::vector<std::vector<ComputeType>>& child_rets) {
+
+    // the buffer of depth d is not touched by the deeper calls
+    std::vector<ComputeType>& ret_vals = child_rets[d];
+    ret_vals.clear();
+
+    if (d < depth) {
+        std::size_t first = first_child(index);
+        for (std::size_t j = first; j < first+Arity; j++) {
+            ComputeType ret = compute_subtree<ComputeType>(depth, j, d+1, element_func, child_rets);
+            ret_vals.push_back(ret);
+        }
+    }
+
+    return element_func(index, d, ret_vals);
+}
+
+// end
@@ -0,0 +1,126 @@
+#ifndef MAPPED_SEQUENCE_H
+#define MAPPED_SEQUENCE_H
+
+#include <cstdlib>
+#include <cstdint>
+
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <Collection.h>
+
+namespace abstract {
+
+// MappedSequence class
+//
+// Persistent sequence of trivially copyable elements stored in a
+// file-backed memory mapping instead of an in-process vector. Opening
+// an existing file maps its elements back instantly, without reading
+// or copying them, and the pages are shared through the OS page cache
+// with other processes mapping the same file.
+//
+// The file starts with a small header (magic, element size, number
+// of elements) followed by the elements; the file and the mapping grow
+// geometrically on add() or explicitly through reserve()
+//
+template <typename ElemType>
+class MappedSequence : public Collection<ElemType> {
+
+    static_assert(std::is_trivially_copyable<ElemType>::value,
+                  "MappedSequence: element type must be trivially copyable");
+
+    public:
+
+        // access pattern hints passed to madvise()
+        enum class Access {
+            normal = 0,
+            sequential,
+            random,
+            willneed,
+            dontneed
+        };
+
+        // opens the file, creating an empty sequence if it does not exist
+        MappedSequence(const std::string& path);
+        ~MappedSequence();
+
+        MappedSequence(const MappedSequence&) = delete;
+        MappedSequence& operator=(const MappedSequence&) = delete;
+
+        ElemType& operator[](const std::size_t i) { return _data[i]; }
+
+        // primitive operations
+        std::size_t size() const { return _header->size; }
+        std::size_t capacity() const { return _capacity; }
+
+        bool empty() const { return size() == 0; }
+
+        void add(ElemType elem);
+        ElemType& at(std::size_t i);
+
+        ElemType* data() { return _data; }
+        const ElemType* data() const { return _data; }
+
+        // grow the file and the mapping to hold at least capacity elements
+        void reserve(std::size_t capacity);
+
+        // truncate the file to the current number of elements
+        void shrink_to_fit();
+
+        void clear() { _header->size = 0; }
+
+        void advise(Access access);
+
+        // flush the mapped pages to the file
+        void sync();
+
+        template<typename MapFunc>
+        void map(MapFunc map_func);
+
+        template<typename OutputStream>
+        void print(OutputStream& out_stream);
+
+    private:
+
+        struct Header {
+            uint64_t magic;
+            uint64_t elem_size;
+            uint64_t size;
+            // pads the header so that elements stay aligned
+            uint64_t reserved[5];
+        };
+
+        static const uint64_t magic = 0x5145534450414d41ULL; // "AMAPDSEQ"
+        static const std::size_t min_capacity = 1024;
+
+        std::size_t file_bytes(std::size_t capacity) const {
+            return sizeof(Header)+capacity*sizeof(ElemType);
+        }
+
+        void remap(std::size_t capacity);
+
+    private:
+
+        std::string _path;
+        int _fd;
+
+        void* _addr;
+        std::size_t _bytes;
+
+        Header* _header;
+        ElemType* _data;
+        std::size_t _capacity;
+};
+
+#include "MappedSequence.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef MAPPED_SEQUENCE_H
@@ -0,0 +1,180 @@
+
+template <typename ElemType>
+const uint64_t MappedSequence<ElemType>::magic;
+
+template <typename ElemType>
+const std::size_t MappedSequence<ElemType>::min_capacity;
+
+template <typename ElemType>
+MappedSequence<ElemType>::MappedSequence(const std::string& path)
+    : _path(path), _fd(-1), _addr(nullptr), _bytes(0),
+      _header(nullptr), _data(nullptr), _capacity(0)
+{
+    _fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0) {
+        std::cerr << "MappedSequence::MappedSequence(): error: cannot open the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    struct stat st;
+    if (fstat(_fd, &st) != 0) {
+        std::cerr << "MappedSequence::MappedSequence(): error: cannot stat the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::size_t bytes = st.st_size;
+
+    if (bytes == 0) {
+        // new sequence
+        remap(min_capacity);
+        _header->magic = magic;
+        _header->elem_size = sizeof(ElemType);
+        _header->size = 0;
+    } else {
+        // reopen an existing sequence in place
+        if (bytes < sizeof(Header)) {
+            std::cerr << "MappedSequence::MappedSequence(): error: the file " << path << " is not a mapped sequence";
+            std::exit(EXIT_FAILURE);
+        }
+        remap((bytes-sizeof(Header))/sizeof(ElemType));
+        if (_header->magic != magic || _header->elem_size != sizeof(ElemType) || _header->size > _capacity) {
+            std::cerr << "MappedSequence::MappedSequence(): error: the file " << path << " does not hold a sequence of this element type";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+template <typename ElemType>
+MappedSequence<ElemType>::~MappedSequence() {
+    if (_addr != nullptr) {
+        munmap(_addr, _bytes);
+    }
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+template <typename ElemType>
+void MappedSequence<ElemType>::remap(std::size_t capacity) {
+
+    std::size_t bytes = file_bytes(capacity);
+
+    if (bytes > _bytes || _addr == nullptr) {
+        struct stat st;
+        if (fstat(_fd, &st) != 0) {
+            std::cerr << "MappedSequence::remap(): error: cannot stat the file " << _path;
+            std::exit(EXIT_FAILURE);
+        }
+        if (static_cast<std::size_t>(st.st_size) < bytes && ftruncate(_fd, bytes) != 0) {
+            std::cerr << "MappedSequence::remap(): error: cannot grow the file " << _path;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    void* addr;
+    if (_addr == nullptr) {
+        addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    } else {
+#ifdef __linux__
+        // let the kernel move the mapping without copying pages
+        addr = mremap(_addr, _bytes, bytes, MREMAP_MAYMOVE);
+#else
+        munmap(_addr, _bytes);
+        addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+#endif
+    }
+
+    if (addr == MAP_FAILED) {
+        std::cerr << "MappedSequence::remap(): error: cannot map the file " << _path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    _addr = addr;
+    _bytes = bytes;
+    _header = static_cast<Header*>(addr);
+    _data = reinterpret_cast<ElemType*>(static_cast<char*>(addr)+sizeof(Header));
+    _capacity = capacity;
+}
+
+template <typename ElemType>
+void MappedSequence<ElemType>::reserve(std::size_t capacity) {
+    if (capacity > _capacity) {
+        remap(capacity);
+    }
+}
+
+template <typename ElemType>
+void MappedSequence<ElemType>::shrink_to_fit() {
+
+    std::size_t capacity = size();
+
+    if (capacity < _capacity) {
+        remap(capacity);
+        if (ftruncate(_fd, file_bytes(capacity)) != 0) {
+            std::cerr << "MappedSequence::shrink_to_fit(): error: cannot truncate the file " << _path;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+template <typename ElemType>
+void MappedSequence<ElemType>::add(ElemType elem) {
+    std::size_t n = size();
+    if (n == _capacity) {
+        reserve((2*_capacity > min_capacity) ? 2*_capacity : min_capacity);
+    }
+    _data[n] = elem;
+    _header->size = n+1;
+}
+
+template <typename ElemType>
+ElemType& MappedSequence<ElemType>::at(std::size_t i) {
+    if (i >= size()) {
+        throw std::out_of_range("MappedSequence::at(): index out of range");
+    }
+    return _data[i];
+}
+
+template <typename ElemType>
+void MappedSequence<ElemType>::advise(Access access) {
+
+    int advice = MADV_NORMAL;
+
+    switch (access) {
+        case Access::sequential: advice = MADV_SEQUENTIAL; break;
+        case Access::random: advice = MADV_RANDOM; break;
+        case Access::willneed: advice = MADV_WILLNEED; break;
+        case Access::dontneed: advice = MADV_DONTNEED; break;
+        default: break;
+    }
+
+    madvise(_addr, _bytes, advice);
+}
+
+template <typename ElemType>
+void MappedSequence<ElemType>::sync() {
+    if (msync(_addr, _bytes, MS_SYNC) != 0) {
+        std::cerr << "MappedSequence::sync(): error: cannot flush the file " << _path;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template <typename ElemType>
+template <typename MapFunc>
+void MappedSequence<ElemType>::map(MapFunc map_func) {
+    std::size_t n = size();
+    for (std::size_t i=0; i<n; i++) {
+        _data[i] = map_func(_data[i]);
+    }
+}
+
+template <typename ElemType>
+template <typename OutputStream>
+void MappedSequence<ElemType>::print(OutputStream& out_stream) {
+    std::size_t n = size();
+    for (std::size_t i=0; i<n; i++) {
+        out_stream << _data[i];
+    }
+}
+
+// end
@@ -0,0 +1,330 @@
+#ifndef ABSTRACT_MEMORY_H
+#define ABSTRACT_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <iostream>
+#include <type_traits>
+
+namespace abstract {
+
+//
+// MemoryResource class
+//
+// Source of the memory the skeletons allocate their elements from. The
+// interface follows std::pmr::memory_resource (not available before
+// C++17) and adds the numbers needed to account for the memory really
+// taken by the allocations. All the resources are thread-safe
+//
+class MemoryResource {
+
+    public:
+
+        static const std::size_t default_alignment = alignof(std::max_align_t);
+
+        virtual ~MemoryResource() {}
+
+        virtual void* allocate(std::size_t bytes, std::size_t alignment = default_alignment) = 0;
+        virtual void deallocate(void* p, std::size_t bytes, std::size_t alignment = default_alignment) = 0;
+
+        // memory a single allocation of the specified size takes
+        // (size rounding, block headers, alignment padding)
+        virtual std::size_t block_size(std::size_t bytes, std::size_t alignment = default_alignment) const = 0;
+
+        // memory obtained from the system that is not handed out
+        // at the moment (free blocks, unused parts of chunks)
+        virtual std::size_t idle_bytes() const { return 0; }
+
+        // memory obtained from the system
+        virtual std::size_t reserved_bytes() const { return 0; }
+};
+
+//
+// HeapResource class
+//
+// plain operator new/delete; the block sizes are those of the glibc
+// allocator (an 8-byte header, 16-byte granularity, 32-byte minimum)
+//
+class HeapResource : public MemoryResource {
+
+    public:
+
+        void* allocate(std::size_t bytes, std::size_t alignment = default_alignment) override;
+        void deallocate(void* p, std::size_t bytes, std::size_t alignment = default_alignment) override;
+
+        std::size_t block_size(std::size_t bytes, std::size_t alignment = default_alignment) const override;
+};
+
+//
+// PerThread class
+//
+// a T instance for every thread which uses the owner object; the
+// instances live as long as the owner and are visited by for_each()
+//
+template <typename T>
+class PerThread {
+
+    public:
+
+        PerThread() : id(next_id()), instances() {}
+
+        PerThread(const PerThread&) = delete;
+        PerThread& operator=(const PerThread&) = delete;
+
+        T& local();
+
+        template <typename Func>
+        void for_each(Func func) const {
+            std::lock_guard<std::mutex> guard(lock);
+            for (const std::unique_ptr<T>& instance : instances) {
+                func(*instance);
+            }
+        }
+
+    private:
+
+        // owners are told apart by unique ids rather than addresses,
+        // which may be reused after an owner has been destroyed
+        static std::uint64_t next_id() {
+            static std::atomic<std::uint64_t> counter(0);
+            return ++counter;
+        }
+
+        struct Slot {
+            std::uint64_t id;
+            T* instance;
+        };
+
+        static std::vector<Slot>& slots() {
+            static thread_local std::vector<Slot> thread_slots;
+            return thread_slots;
+        }
+
+    private:
+
+        std::uint64_t id;
+        mutable std::mutex lock;
+        std::vector<std::unique_ptr<T>> instances;
+};
+
+//
+// ThreadLocalPool class
+//
+// Pool of fixed-size blocks for small objects (up to max_block bytes,
+// rounded up to 16-byte size classes). Every thread carves its blocks
+// out of its own chunks and keeps freed blocks in its own free lists,
+// so allocations never contend on a lock. A block freed by another
+// thread joins the free list of that thread. Chunks are returned to
+// the system when the pool is destroyed. Larger or over-aligned
+// requests are passed to the heap
+//
+class ThreadLocalPool : public MemoryResource {
+
+    public:
+
+        static const std::size_t granularity = 16;
+
+        ThreadLocalPool(std::size_t max_block = 512, std::size_t chunk_bytes = 64*1024);
+        ~ThreadLocalPool();
+
+        ThreadLocalPool(const ThreadLocalPool&) = delete;
+        ThreadLocalPool& operator=(const ThreadLocalPool&) = delete;
+
+        void* allocate(std::size_t bytes, std::size_t alignment = default_alignment) override;
+        void deallocate(void* p, std::size_t bytes, std::size_t alignment = default_alignment) override;
+
+        std::size_t block_size(std::size_t bytes, std::size_t alignment = default_alignment) const override;
+
+        std::size_t idle_bytes() const override;
+        std::size_t reserved_bytes() const override;
+
+    private:
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Cache {
+            std::vector<FreeBlock*> free_lists; // per size class
+            std::vector<void*> chunks;
+            char* current;   // unused part of the last chunk
+            char* limit;
+            // written by the owner thread only; may go negative when
+            // the thread frees blocks allocated by others
+            std::atomic<std::ptrdiff_t> in_use;
+            std::atomic<std::size_t> reserved;
+        };
+
+        bool pooled(std::size_t bytes, std::size_t alignment) const {
+            return bytes <= max_block && alignment <= granularity;
+        }
+
+        static std::size_t size_class(std::size_t bytes) {
+            return (bytes > 0) ? (bytes-1)/granularity : 0;
+        }
+
+    private:
+
+        std::size_t max_block;
+        std::size_t chunk_bytes;
+        PerThread<Cache> caches;
+        HeapResource heap;
+};
+
+//
+// MonotonicArena class
+//
+// Bump allocator: every thread hands out consecutive pieces of its own
+// chunks, deallocate() does nothing and all the memory is released at
+// once when the arena is destroyed. Suits skeletons which are grown
+// once and dropped as a whole
+//
+class MonotonicArena : public MemoryResource {
+
+    public:
+
+        MonotonicArena(std::size_t chunk_bytes = 1024*1024);
+        ~MonotonicArena();
+
+        MonotonicArena(const MonotonicArena&) = delete;
+        MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+        void* allocate(std::size_t bytes, std::size_t alignment = default_alignment) override;
+        void deallocate(void*, std::size_t, std::size_t = default_alignment) override {}
+
+        std::size_t block_size(std::size_t bytes, std::size_t alignment = default_alignment) const override {
+            return (bytes+alignment-1)/alignment*alignment;
+        }
+
+        std::size_t idle_bytes() const override;
+        std::size_t reserved_bytes() const override;
+
+    private:
+
+        struct Cache {
+            std::vector<void*> chunks;
+            char* current;
+            char* limit;
+            std::atomic<std::size_t> used;
+            std::atomic<std::size_t> reserved;
+        };
+
+    private:
+
+        std::size_t chunk_bytes;
+        PerThread<Cache> caches;
+};
+
+// the default resource of the skeletons
+inline MemoryResource& heap_resource() {
+    static HeapResource resource;
+    return resource;
+}
+
+// construct an object in the memory of the resource
+template <typename ObjectType, typename... Args>
+ObjectType* create_object(MemoryResource& resource, Args&&... args);
+
+// destroy an object created with create_object()
+template <typename ObjectType>
+void destroy_object(MemoryResource& resource, ObjectType* object);
+
+//
+// ResourceDeleter class
+//
+// deleter of the std::unique_ptr<BaseType> owning an object created
+// with create_object<ObjectType>(); objects of a BaseType which is not
+// a base of ObjectType are destroyed as BaseType objects
+//
+template <typename BaseType, typename ObjectType>
+class ResourceDeleter {
+
+    public:
+
+        ResourceDeleter(MemoryResource* resource = nullptr) : resource(resource) {}
+
+        void operator()(BaseType* p) const {
+            destroy(p, std::is_base_of<BaseType,ObjectType>());
+        }
+
+        // the resource the object has been allocated from
+        MemoryResource* get_resource() const { return resource; }
+
+    private:
+
+        void destroy(BaseType* p, std::true_type) const {
+            destroy_object(*resource, static_cast<ObjectType*>(p));
+        }
+
+        void destroy(BaseType* p, std::false_type) const {
+            destroy_object(*resource, p);
+        }
+
+    private:
+
+        MemoryResource* resource;
+};
+
+//
+// MemoryUsage struct
+//
+// memory footprint of a skeleton:
+//
+// payload    - user data of the elements
+// structural - what the skeleton keeps to organize the elements:
+//              element headers, structural links, seeds, index arrays
+// allocator  - allocation overhead: block headers, size rounding
+//              and padding of the element allocations
+//
+struct MemoryUsage {
+
+    MemoryUsage() : payload(0), structural(0), allocator(0) {}
+
+    std::size_t total() const { return payload+structural+allocator; }
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        payload += other.payload;
+        structural += other.structural;
+        allocator += other.allocator;
+        return *this;
+    }
+
+    // count n blocks of bytes each allocated from the resource
+    void add_blocks(const MemoryResource& resource, std::size_t n, std::size_t bytes, std::size_t alignment) {
+        allocator += n*(resource.block_size(bytes, alignment)-bytes);
+    }
+
+    // count the buffer of a std::vector (allocated from the heap)
+    // into the specified part of the footprint
+    template <typename T>
+    void add_vector(std::size_t MemoryUsage::* part, const std::vector<T>& vec) {
+        std::size_t bytes = vec.capacity()*sizeof(T);
+        if (bytes > 0) {
+            this->*part += bytes;
+            add_blocks(heap_resource(), 1, bytes, alignof(T));
+        }
+    }
+
+    std::size_t payload;
+    std::size_t structural;
+    std::size_t allocator;
+};
+
+inline std::ostream& operator<<(std::ostream& outs, const MemoryUsage& usage) {
+    outs << "payload " << usage.payload << " B, structural " << usage.structural
+         << " B, allocator " << usage.allocator << " B, total " << usage.total() << " B";
+    return outs;
+}
+
+#include "Memory.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_MEMORY_H
@@ -0,0 +1,229 @@
+
+inline void* HeapResource::allocate(std::size_t bytes, std::size_t alignment) {
+    if (alignment <= default_alignment) {
+        return ::operator new(bytes);
+    }
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment, bytes) != 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+inline void HeapResource::deallocate(void* p, std::size_t, std::size_t alignment) {
+    if (alignment <= default_alignment) {
+        ::operator delete(p);
+    } else {
+        std::free(p);
+    }
+}
+
+inline std::size_t HeapResource::block_size(std::size_t bytes, std::size_t alignment) const {
+    std::size_t block = (bytes+8+15) & ~static_cast<std::size_t>(15);
+    if (block < 32) {
+        block = 32;
+    }
+    // the worst case padding of an over-aligned block
+    return (alignment <= default_alignment) ? block : block+alignment;
+}
+
+template <typename T>
+T& PerThread<T>::local() {
+
+    std::vector<Slot>& thread_slots = slots();
+
+    for (const Slot& slot : thread_slots) {
+        if (slot.id == id) {
+            return *slot.instance;
+        }
+    }
+
+    // the first use by the calling thread
+    T* instance = new T();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        instances.emplace_back(instance);
+    }
+    thread_slots.push_back(Slot{id, instance});
+
+    return *instance;
+}
+
+inline ThreadLocalPool::ThreadLocalPool(std::size_t max_block, std::size_t chunk_bytes)
+    : max_block((max_block+granularity-1)/granularity*granularity),
+      chunk_bytes(chunk_bytes), caches(), heap()
+{
+    if (this->chunk_bytes < this->max_block) {
+        this->chunk_bytes = this->max_block;
+    }
+}
+
+inline ThreadLocalPool::~ThreadLocalPool() {
+    caches.for_each([this](const Cache& cache) {
+        for (void* chunk : cache.chunks) {
+            heap.deallocate(chunk, chunk_bytes);
+        }
+    });
+}
+
+inline void* ThreadLocalPool::allocate(std::size_t bytes, std::size_t alignment) {
+
+    if (!pooled(bytes, alignment)) {
+        return heap.allocate(bytes, alignment);
+    }
+
+    Cache& cache = caches.local();
+
+    std::size_t c = size_class(bytes);
+    std::size_t block = (c+1)*granularity;
+
+    if (cache.free_lists.empty()) {
+        cache.free_lists.assign(max_block/granularity, nullptr);
+    }
+
+    cache.in_use.store(cache.in_use.load(std::memory_order_relaxed)+block, std::memory_order_relaxed);
+
+    FreeBlock* head = cache.free_lists[c];
+    if (head != nullptr) {
+        cache.free_lists[c] = head->next;
+        return head;
+    }
+
+    if (cache.current == nullptr || static_cast<std::size_t>(cache.limit-cache.current) < block) {
+        // the tail of the previous chunk stays unused
+        char* chunk = static_cast<char*>(heap.allocate(chunk_bytes));
+        cache.chunks.push_back(chunk);
+        cache.current = chunk;
+        cache.limit = chunk+chunk_bytes;
+        cache.reserved.store(cache.reserved.load(std::memory_order_relaxed)+chunk_bytes, std::memory_order_relaxed);
+    }
+
+    void* p = cache.current;
+    cache.current += block;
+    return p;
+}
+
+inline void ThreadLocalPool::deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+
+    if (p == nullptr) {
+        return;
+    }
+
+    if (!pooled(bytes, alignment)) {
+        heap.deallocate(p, bytes, alignment);
+        return;
+    }
+
+    Cache& cache = caches.local();
+
+    std::size_t c = size_class(bytes);
+    std::size_t block = (c+1)*granularity;
+
+    if (cache.free_lists.empty()) {
+        cache.free_lists.assign(max_block/granularity, nullptr);
+    }
+
+    FreeBlock* head = static_cast<FreeBlock*>(p);
+    head->next = cache.free_lists[c];
+    cache.free_lists[c] = head;
+
+    cache.in_use.store(cache.in_use.load(std::memory_order_relaxed)-static_cast<std::ptrdiff_t>(block), std::memory_order_relaxed);
+}
+
+inline std::size_t ThreadLocalPool::block_size(std::size_t bytes, std::size_t alignment) const {
+    if (!pooled(bytes, alignment)) {
+        return heap.block_size(bytes, alignment);
+    }
+    return (size_class(bytes)+1)*granularity;
+}
+
+inline std::size_t ThreadLocalPool::reserved_bytes() const {
+    std::size_t reserved = 0;
+    caches.for_each([&](const Cache& cache) {
+        reserved += cache.reserved.load(std::memory_order_relaxed);
+    });
+    return reserved;
+}
+
+inline std::size_t ThreadLocalPool::idle_bytes() const {
+    std::ptrdiff_t in_use = 0;
+    caches.for_each([&](const Cache& cache) {
+        in_use += cache.in_use.load(std::memory_order_relaxed);
+    });
+    std::size_t reserved = reserved_bytes();
+    return (in_use > 0) ? reserved-static_cast<std::size_t>(in_use) : reserved;
+}
+
+inline MonotonicArena::MonotonicArena(std::size_t chunk_bytes)
+    : chunk_bytes(chunk_bytes), caches() {}
+
+inline MonotonicArena::~MonotonicArena() {
+    caches.for_each([](const Cache& cache) {
+        for (void* chunk : cache.chunks) {
+            ::operator delete(chunk);
+        }
+    });
+}
+
+inline void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment) {
+
+    Cache& cache = caches.local();
+
+    std::uintptr_t current = reinterpret_cast<std::uintptr_t>(cache.current);
+    std::uintptr_t aligned = (current+alignment-1)/alignment*alignment;
+
+    if (cache.current == nullptr || aligned+bytes > reinterpret_cast<std::uintptr_t>(cache.limit)) {
+        // requests larger than a chunk get a chunk of their own
+        std::size_t size = (bytes+alignment > chunk_bytes) ? bytes+alignment : chunk_bytes;
+        char* chunk = static_cast<char*>(::operator new(size));
+        cache.chunks.push_back(chunk);
+        cache.current = chunk;
+        cache.limit = chunk+size;
+        cache.reserved.store(cache.reserved.load(std::memory_order_relaxed)+size, std::memory_order_relaxed);
+
+        current = reinterpret_cast<std::uintptr_t>(chunk);
+        aligned = (current+alignment-1)/alignment*alignment;
+    }
+
+    cache.current = reinterpret_cast<char*>(aligned+bytes);
+    cache.used.store(cache.used.load(std::memory_order_relaxed)+(aligned-current)+bytes, std::memory_order_relaxed);
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+inline std::size_t MonotonicArena::reserved_bytes() const {
+    std::size_t reserved = 0;
+    caches.for_each([&](const Cache& cache) {
+        reserved += cache.reserved.load(std::memory_order_relaxed);
+    });
+    return reserved;
+}
+
+inline std::size_t MonotonicArena::idle_bytes() const {
+    std::size_t used = 0;
+    caches.for_each([&](const Cache& cache) {
+        used += cache.used.load(std::memory_order_relaxed);
+    });
+    return reserved_bytes()-used;
+}
+
+template <typename ObjectType, typename... Args>
+ObjectType* create_object(MemoryResource& resource, Args&&... args) {
+    void* p = resource.allocate(sizeof(ObjectType), alignof(ObjectType));
+    try {
+        return new (p) ObjectType(std::forward<Args>(args)...);
+    } catch (...) {
+        resource.deallocate(p, sizeof(ObjectType), alignof(ObjectType));
+        throw;
+    }
+}
+
+template <typename ObjectType>
+void destroy_object(MemoryResource& resource, ObjectType* object) {
+    if (object != nullptr) {
+        object->~ObjectType();
+        resource.deallocate(object, sizeof(ObjectType), alignof(ObjectType));
+    }
+}
+
+// end
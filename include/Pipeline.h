@@ -0,0 +1,142 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstdlib>
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <omp.h>
+
+namespace abstract {
+
+template <typename ElemType>
+class Sequence;
+
+//
+// Pipeline stages
+//
+// Stages are composed into a single function object by expression
+// templates: every stage wraps the previous one and evaluates it inline.
+// A stage computes the value of the pipeline for a source element and
+// returns false if the element has been filtered out
+//
+
+template <typename ElemType>
+class PipelineSource {
+
+    public:
+
+        using Value_t = ElemType;
+
+        bool operator()(const ElemType& in, Value_t& out) const {
+            out = in;
+            return true;
+        }
+};
+
+template <typename PrevStage, typename MapFunc>
+class PipelineMap {
+
+    public:
+
+        using Value_t = typename std::decay<decltype(std::declval<const MapFunc&>()(std::declval<typename PrevStage::Value_t>()))>::type;
+
+        PipelineMap(PrevStage prev, MapFunc func)
+            : prev(prev), func(func) {}
+
+        template <typename ElemType>
+        bool operator()(const ElemType& in, Value_t& out) const {
+            typename PrevStage::Value_t val;
+            if (!prev(in, val)) {
+                return false;
+            }
+            out = func(val);
+            return true;
+        }
+
+    private:
+
+        PrevStage prev;
+        MapFunc func;
+};
+
+template <typename PrevStage, typename FilterFunc>
+class PipelineFilter {
+
+    public:
+
+        using Value_t = typename PrevStage::Value_t;
+
+        PipelineFilter(PrevStage prev, FilterFunc pred)
+            : prev(prev), pred(pred) {}
+
+        template <typename ElemType>
+        bool operator()(const ElemType& in, Value_t& out) const {
+            return prev(in, out) && pred(out);
+        }
+
+    private:
+
+        PrevStage prev;
+        FilterFunc pred;
+};
+
+//
+// Pipeline class
+//
+// Lazy pipeline of map and filter stages over the elements of a
+// Sequence. Stages only compose the pipeline; nothing is evaluated
+// until a terminal operation (reduce(), count(), collect()) runs, which
+// makes a single fused pass over the elements. The pass is split into
+// contiguous chunks processed in parallel; the inner loop over a chunk
+// is straight-line code for chains of maps and can be vectorized
+//
+template <typename ElemType, typename StageType>
+class Pipeline {
+
+    public:
+
+        using Elem_t = ElemType;
+        using Value_t = typename StageType::Value_t;
+
+        // minimal number of elements processed by a thread
+        static const std::size_t grain_size = 4096;
+
+        Pipeline(const ElemType* data, std::size_t size, StageType stage)
+            : data(data), size(size), stage(stage) {}
+
+        // stages
+        template <typename MapFunc>
+        Pipeline<ElemType,PipelineMap<StageType,MapFunc>> map(MapFunc map_func) const;
+
+        template <typename FilterFunc>
+        Pipeline<ElemType,PipelineFilter<StageType,FilterFunc>> filter(FilterFunc filter_func) const;
+
+        // terminal operations
+        //
+        // reduce_func must be associative: values are reduced per chunk
+        // and the chunk values are combined in their order
+        template <typename ReduceFunc>
+        Value_t reduce(Value_t identity, ReduceFunc reduce_func) const;
+
+        std::size_t count() const;
+
+        Sequence<Value_t> collect() const;
+
+    private:
+
+        int chunks_num() const;
+
+    private:
+
+        const ElemType* data;
+        std::size_t size;
+        StageType stage;
+};
+
+#include "Pipeline.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef PIPELINE_H
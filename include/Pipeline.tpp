@@ -0,0 +1,116 @@
+
+template <typename ElemType, typename StageType>
+const std::size_t Pipeline<ElemType,StageType>::grain_size;
+
+template <typename ElemType, typename StageType>
+template <typename MapFunc>
+Pipeline<ElemType,PipelineMap<StageType,MapFunc>> Pipeline<ElemType,StageType>::map(MapFunc map_func) const {
+    return Pipeline<ElemType,PipelineMap<StageType,MapFunc>>(data, size, PipelineMap<StageType,MapFunc>(stage, map_func));
+}
+
+template <typename ElemType, typename StageType>
+template <typename FilterFunc>
+Pipeline<ElemType,PipelineFilter<StageType,FilterFunc>> Pipeline<ElemType,StageType>::filter(FilterFunc filter_func) const {
+    return Pipeline<ElemType,PipelineFilter<StageType,FilterFunc>>(data, size, PipelineFilter<StageType,FilterFunc>(stage, filter_func));
+}
+
+template <typename ElemType, typename StageType>
+int Pipeline<ElemType,StageType>::chunks_num() const {
+    std::size_t max_threads = omp_get_max_threads();
+    std::size_t chunks = (size+grain_size-1)/grain_size;
+    chunks = (chunks <= max_threads) ? chunks : max_threads;
+    return (chunks > 0) ? chunks : 1;
+}
+
+template <typename ElemType, typename StageType>
+template <typename ReduceFunc>
+typename Pipeline<ElemType,StageType>::Value_t Pipeline<ElemType,StageType>::reduce(Value_t identity, ReduceFunc reduce_func) const {
+
+    int chunks = chunks_num();
+    std::vector<Value_t> partials(chunks, identity);
+
+    #pragma omp parallel for schedule(static) shared(partials) num_threads(chunks) if(chunks > 1)
+    for (int c=0; c<chunks; c++) {
+        std::size_t begin = (size*c)/chunks;
+        std::size_t end = (size*(c+1))/chunks;
+        Value_t partial = identity;
+        for (std::size_t i=begin; i<end; i++) {
+            Value_t val;
+            if (stage(data[i], val)) {
+                partial = reduce_func(partial, val);
+            }
+        }
+        partials[c] = partial;
+    }
+
+    Value_t ret = partials[0];
+    for (int c=1; c<chunks; c++) {
+        ret = reduce_func(ret, partials[c]);
+    }
+    return ret;
+}
+
+template <typename ElemType, typename StageType>
+std::size_t Pipeline<ElemType,StageType>::count() const {
+
+    int chunks = chunks_num();
+    std::size_t ret = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:ret) num_threads(chunks) if(chunks > 1)
+    for (int c=0; c<chunks; c++) {
+        std::size_t begin = (size*c)/chunks;
+        std::size_t end = (size*(c+1))/chunks;
+        for (std::size_t i=begin; i<end; i++) {
+            Value_t val;
+            ret += stage(data[i], val) ? 1 : 0;
+        }
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename StageType>
+Sequence<typename Pipeline<ElemType,StageType>::Value_t> Pipeline<ElemType,StageType>::collect() const {
+
+    int chunks = chunks_num();
+    std::vector<std::vector<Value_t>> outputs(chunks);
+    std::vector<std::size_t> offsets(chunks+1, 0);
+
+    Sequence<Value_t> ret;
+
+    #pragma omp parallel num_threads(chunks) shared(outputs,offsets,ret) if(chunks > 1)
+    {
+        // evaluate the chunks into chunk-local outputs
+        #pragma omp for schedule(static)
+        for (int c=0; c<chunks; c++) {
+            std::size_t begin = (size*c)/chunks;
+            std::size_t end = (size*(c+1))/chunks;
+            std::vector<Value_t>& out = outputs[c];
+            out.reserve(end-begin);
+            for (std::size_t i=begin; i<end; i++) {
+                Value_t val;
+                if (stage(data[i], val)) {
+                    out.push_back(val);
+                }
+            }
+        }
+
+        // positions of the chunk outputs in the result
+        #pragma omp single
+        {
+            for (int c=0; c<chunks; c++) {
+                offsets[c+1] = offsets[c]+outputs[c].size();
+            }
+            ret._vec.resize(offsets[chunks]);
+        }
+
+        #pragma omp for schedule(static)
+        for (int c=0; c<chunks; c++) {
+            std::move(outputs[c].begin(), outputs[c].end(), ret._vec.begin()+offsets[c]);
+        }
+    }
+
+    return ret;
+}
+
+// end
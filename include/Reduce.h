@@ -1,15 +1,32 @@
 #ifndef ABSTRACT_REDUCE_H
 #define ABSTRACT_REDUCE_H
 
+#include <cstdlib>
 #include <iostream>
 #include <vector>
+#include <unordered_map>
+#include <functional>
 #include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <type_traits>
 #include <omp.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Framework.h"
+
 namespace abstract {
 
 template <typename ElemType, typename SeedType, typename InjectType>
-class Reduce
+class Reduce : public Framework
 {
     public:
 
@@ -22,6 +39,22 @@ class Reduce
             parallel
         };
 
+        // OPTIMIZATION HINT
+        //
+        // general combine collects the values reduced from all 
+        // the elements into an indexed vector and passes it to 
+        // the user-defined final combine function
+        //
+        // associative combine accumulates the values into per-thread
+        // partials without the width-sized vector and merges these 
+        // partials pairwise in a parallel tree; ComputeFunction::combine()
+        // must be associative for this to be correct
+        //
+        enum class CombineType {
+            general = 0,
+            associative
+        };
+
         // ElementInfo class 
         //
         // builds the location information of an element 
@@ -48,6 +81,39 @@ class Reduce
         template <typename ComputeType>
         class ComputeFunction;
 
+        // Column class
+        //
+        // Snapshot of a numeric field of all the Reduce elements,
+        // gathered into a contiguous array (see gather()). Provides
+        // built-in vectorized reduction kernels, which run over the
+        // array directly instead of calling a virtual compute function
+        // for every element. The elements themselves stay where they
+        // are: the column is a copy, and changes to it reach the
+        // elements through scatter() only
+        //
+        template <typename FieldType>
+        class Column;
+
+        // RangeIndex class
+        //
+        // Segment tree built over the Reduce elements, which stores 
+        // partial values of a compute function hierarchically. Answers
+        // range reductions and refreshes the result after an update of
+        // a single element in O(log width) calls to the combine function
+        //
+        template <typename ComputeType>
+        class RangeIndex;
+
+        // Groups class
+        //
+        // Result of a grouped compute: the aggregates of the groups
+        // kept in the hash tables of disjoint key partitions they have
+        // been merged in, so that no serial pass has to put them into
+        // a single table
+        //
+        template <typename KeyType, typename ComputeType>
+        class Groups;
+
         Reduce();
         ~Reduce();
        
@@ -64,6 +130,38 @@ class Reduce
         //
         Reduce<ElemType,SeedType,InjectType>& inject(const InjectType data);
 
+        //
+        // bind()/map()/unbind()
+        //
+        // bind the reduction to external data instead of growing its 
+        // own elements: an existing contiguous range of elements or a
+        // binary file of fixed-size records mapped into memory. compute()
+        // and inject() then run directly over that memory without any
+        // per-element allocation or copying
+        //
+        // ElemType does not have to be derived from Reduce::Element in
+        // this mode; inject() requires it to provide an inject(data)
+        // method. A file is mapped privately (copy-on-write) unless it
+        // is writable, in which case injected data ends up in the file
+        //
+        Reduce<ElemType,SeedType,InjectType>& bind(ElemType* data, size_t width);
+        Reduce<ElemType,SeedType,InjectType>& map(const std::string& path, bool writable = false);
+        Reduce<ElemType,SeedType,InjectType>& unbind();
+
+        bool is_bound() const { return view != nullptr; }
+
+        //
+        // set_partition()
+        //
+        // makes grow() create only the elements [first, last) of the
+        // reduction, which keep their indices in the whole reduction;
+        // compute() then reduces this part only. Spreads a reduction
+        // over several processes, see Distributed.h
+        //
+        void set_partition(size_t first, size_t last);
+        void clear_partition() { partitioned = false; }
+        bool is_partitioned() const { return partitioned; }
+
         //
         // main compute() interface
         //
@@ -72,14 +170,171 @@ class Reduce
         template<typename ComputeType>
         ComputeType compute(Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
 
+        //
+        // grow_async()/compute_async()
+        //
+        // grow() and compute() started on the executor of the reduction,
+        // returning at once with a future of the result; see Fractal.
+        // The reduction and the function must outlive the call, and the
+        // reduction must not be used until the future is ready
+        //
+        std::future<Reduce<ElemType,SeedType,InjectType>&> grow_async(size_t width);
+        std::future<Reduce<ElemType,SeedType,InjectType>&> grow_async(size_t width, SeedType seed);
+
+        template<typename ComputeType>
+        std::future<ComputeType> compute_async(Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
+
+        //
+        // memory_usage()
+        //
+        // memory taken by the elements of the reduction; bound
+        // external data is counted as payload only
+        //
+        MemoryUsage memory_usage() const;
+
+        //
+        // compute_batch()
+        //
+        // Batched inject-and-compute: evaluates the reductions for all
+        // the specified inject values in a single pass over the elements.
+        // Every element is injected with each of the values in turn and
+        // computed right away while it is still hot in cache. Returns one
+        // result per inject value, the same as inject() followed by
+        // compute() with the combine type of the reduction; the elements
+        // keep the last injected value. Under the general combine type
+        // the values are processed in groups of 16, one pass per group,
+        // since all the element results of a group are kept for the
+        // final reduction
+        //
+        template<typename ComputeType>
+        std::vector<ComputeType> compute_batch(const std::vector<InjectType>& data,
+                                               Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
+
+        //
+        // compute_stream()
+        //
+        // Streaming compute over elements delivered by a producer in
+        // fixed-size chunks, so that the whole width never has to be
+        // resident in memory. producer(chunk, chunk_size) appends at 
+        // most chunk_size elements to the empty chunk vector; an empty
+        // chunk marks the end of the stream
+        //
+        // Every chunk is reduced with the associative combine of the
+        // implementation type of the reduction and folded into a running
+        // partial. The producer runs on a thread of its own for the whole
+        // stream and fills the next chunk while the current one is being
+        // reduced (double buffering); an exception thrown by the producer
+        // is rethrown by compute_stream()
+        //
+        template<typename ComputeType, typename ProducerFunc>
+        ComputeType compute_stream(ProducerFunc producer, size_t chunk_size, 
+                                   Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
+
+        //
+        // compute_grouped()
+        //
+        // Grouped compute (reduce-by-key): every element is reduced 
+        // into the group of the key key_func(element) returns, and the 
+        // aggregate of every group is returned in a map
+        //
+        // Elements are accumulated into thread-local hash tables, already
+        // split into key partitions; the partitions are then merged in
+        // parallel with ComputeFunction::combine(), in the order of the
+        // threads' blocks of elements, and returned as they are
+        //
+        template<typename KeyType, typename ComputeType, typename KeyFunc>
+        Groups<KeyType,ComputeType> compute_grouped(KeyFunc key_func, 
+                                                    Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
+
+        //
+        // build_index()
+        //
+        // builds a RangeIndex over the current elements; the index
+        // keeps references to the reduction and the compute function
+        //
+        template<typename ComputeType>
+        RangeIndex<ComputeType> build_index(Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& func);
+
+        //
+        // gather()/scatter()
+        //
+        // copy the specified field of all Reduce elements into a
+        // contiguous column, and copy a (modified) column back into
+        // the elements. The column takes memory of its own and does
+        // not follow later changes of the elements
+        //
+        template <typename FieldType>
+        Column<FieldType> gather(FieldType ElemType::* field);
+        
+        template <typename FieldType>
+        Reduce<ElemType,SeedType,InjectType>& scatter(const Column<FieldType>& col, FieldType ElemType::* field);
+
         void set_impl_type(ImplType t) { impl_type = t; }
         ImplType get_impl_type() const { return impl_type; }
 
+        void set_combine_type(CombineType t) { combine_type = t; }
+        CombineType get_combine_type() const { return combine_type; }
+
+    private:
+
+        bool is_parallel() const { return impl_type == ImplType::parallel; }
+
+        // elements are allocated from the memory resource of the reduction
+        using ElementPtr = std::unique_ptr<Element,ResourceDeleter<Element,ElemType>>;
+
+        ElementPtr new_element(const ElementInfo& info) {
+            MemoryResource& resource = this->memory_resource();
+            ElementPtr elem(create_object<ElemType>(resource, info), ResourceDeleter<Element,ElemType>(&resource));
+            return elem;
+        }
+
+        // element access regardless of whether the reduction owns its
+        // elements or runs over bound external data
+        ElemType& element_at(size_t i) {
+            return element_at(i, std::is_base_of<Element,ElemType>());
+        }
+        
+        ElemType& element_at(size_t i, std::true_type) {
+            return (view != nullptr) ? view[i] : *static_cast<ElemType*>(elements[i].get());
+        }
+        
+        ElemType& element_at(size_t i, std::false_type) {
+            return view[i];
+        }
+
+        // private framework computation methods
+        // (implement compute() method)
+        template <typename ComputeType>
+        ComputeType compute_general(ComputeFunction<ComputeType>& compute_func);
+
+        template <typename ComputeType>
+        ComputeType compute_associative(ComputeFunction<ComputeType>& compute_func);
+
+        // accumulate n elements obtained through element_at(i) into
+        // per-thread partials and combine them into a single value
+        template <typename ComputeType, typename AccessFunc>
+        ComputeType accumulate(size_t n, AccessFunc element_at, ComputeFunction<ComputeType>& compute_func);
+
+        // combine partials pairwise in a tree, preserving their order
+        template <typename ComputeType>
+        ComputeType combine_tree(std::vector<ComputeType>& partials, ComputeFunction<ComputeType>& compute_func);
+
     private:
         
         ImplType impl_type;
+        CombineType combine_type;
         int width;
-        std::vector<std::unique_ptr<Element>> elements;
+        std::vector<ElementPtr> elements;
+
+        // part of the reduction grown by grow()
+        bool partitioned;
+        size_t part_first;
+        size_t part_last;
+
+        // external data the reduction is bound to
+        ElemType* view;
+        size_t view_bytes;
+        bool view_mapped;
 };
 
 template <typename ElemType, typename SeedType, typename InjectType> 
@@ -172,6 +427,195 @@ class Reduce<ElemType,SeedType,InjectType>::ComputeFunction {
             }
             return ret;
         }
+
+        //
+        // Function to specify how to combine two partial values
+        //
+        // Used by the associative combine instead of the function 
+        // above; must be associative, the order of the operands 
+        // is always preserved
+        //
+        virtual ComputeType combine(const ComputeType& lhs, const ComputeType& rhs) {
+            ComputeType ret = lhs;
+            ret += rhs;
+            return ret;
+        }
+
+        //
+        // Function to specify how to fold a single element into 
+        // a running partial value
+        //
+        // Can be overridden to update the partial in place instead
+        // of reducing the element and combining the two values
+        //
+        virtual void accumulate(ComputeType& partial, ElemType& element) {
+            partial = combine(partial, (*this)(element));
+        }
+};
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+class Reduce<ElemType,SeedType,InjectType>::Column {
+
+    friend class Reduce<ElemType,SeedType,InjectType>;
+
+    public:
+        
+        using Field_t = FieldType;
+
+        Column(size_t size, ImplType t = ImplType::sequential) 
+            : impl_type(t), values(size) {}
+
+        size_t size() const { return values.size(); }
+        
+        FieldType* data() { return values.data(); }
+        const FieldType* data() const { return values.data(); }
+
+        FieldType& operator[](size_t i) { return values[i]; }
+        const FieldType& operator[](size_t i) const { return values[i]; }
+
+        void set_impl_type(ImplType t) { impl_type = t; }
+        ImplType get_impl_type() const { return impl_type; }
+
+        //
+        // built-in reduction kernels
+        //
+        // vectorized with OpenMP simd; spread across threads when the
+        // column is of the parallel implementation type. argmin() and
+        // argmax() give the first index of the extreme value (of the
+        // first NaN if there are any)
+        //
+        FieldType sum() const;
+        FieldType min() const;
+        FieldType max() const;
+        size_t argmin() const;
+        size_t argmax() const;
+        FieldType dot(const Column<FieldType>& other) const;
+        
+        template <typename Predicate>
+        size_t count_if(Predicate pred) const;
+
+    private:
+        
+        bool is_parallel() const { return impl_type == ImplType::parallel; }
+        
+        void check_not_empty(const char* kernel) const {
+            if (values.empty()) {
+                std::cerr << "Reduce::Column::" << kernel << "(): error: cannot reduce an empty column";
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        // index of the element preceding all the others, the
+        // first one among equals; a single pass over the column
+        template <typename Precedes>
+        size_t find_extreme(Precedes precedes) const;
+
+        // the NaNs of a floating point column come first in both
+        // orders, as do they in its minimum and maximum
+        static bool is_nan(FieldType x) { return x != x; }
+
+    private:
+        
+        ImplType impl_type;
+        std::vector<FieldType> values;
+};
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename KeyType, typename ComputeType>
+class Reduce<ElemType,SeedType,InjectType>::Groups {
+
+    friend class Reduce<ElemType,SeedType,InjectType>;
+
+    public:
+
+        using Table_t = std::unordered_map<KeyType,ComputeType>;
+
+        // the number of groups
+        size_t size() const {
+            size_t ret = 0;
+            for (const Table_t& table : parts) {
+                ret += table.size();
+            }
+            return ret;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        // lookups go to the partition of the key
+        size_t count(const KeyType& key) const { return part(key).count(key); }
+        ComputeType& at(const KeyType& key) { return part(key).at(key); }
+        const ComputeType& at(const KeyType& key) const { return part(key).at(key); }
+
+        // func(const KeyType& key, const ComputeType& aggregate)
+        template <typename Func>
+        void for_each(Func func) const {
+            for (const Table_t& table : parts) {
+                for (const auto& kv : table) {
+                    func(kv.first, kv.second);
+                }
+            }
+        }
+
+        // the partitions hold disjoint sets of keys
+        // and can be processed in parallel
+        const std::vector<Table_t>& partitions() const { return parts; }
+        std::vector<Table_t>& partitions() { return parts; }
+
+    private:
+
+        Groups(int parts_num) : parts(parts_num) {}
+
+        // mixes the hash, so that partitions do not
+        // correlate with the buckets of the tables
+        static int partition_of(const KeyType& key, int parts_num) {
+            unsigned long long h = std::hash<KeyType>()(key);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            return h % parts_num;
+        }
+
+        Table_t& part(const KeyType& key) { return parts[partition_of(key, parts.size())]; }
+        const Table_t& part(const KeyType& key) const { return parts[partition_of(key, parts.size())]; }
+
+    private:
+
+        std::vector<Table_t> parts;
+};
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+class Reduce<ElemType,SeedType,InjectType>::RangeIndex {
+
+    public:
+
+        using Compute_t = ComputeType;
+        
+        RangeIndex(Reduce<ElemType,SeedType,InjectType>& reduce, ComputeFunction<ComputeType>& func);
+
+        size_t size() const { return width; }
+        
+        // reduction of the elements [begin, end)
+        ComputeType query(size_t begin, size_t end) const;
+        
+        // reduction of all the elements
+        ComputeType total() const { return query(0, width); }
+        
+        // recompute the value of the i-th element after it has been 
+        // changed and propagate it up the tree
+        void update(size_t i);
+
+    private:
+
+        Reduce<ElemType,SeedType,InjectType>* reduce;
+        ComputeFunction<ComputeType>* compute_func;
+        
+        size_t width;
+        
+        // bottom-up segment tree laid out as a heap: the leaves
+        // occupy [width, 2*width), node p combines 2p and 2p+1
+        std::vector<ComputeType> tree;
 };
 
 #include "Reduce.tpp"
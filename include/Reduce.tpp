@@ -1,10 +1,25 @@
 
 template <typename ElemType, typename SeedType, typename InjectType>
 Reduce<ElemType,SeedType,InjectType>::Reduce()
-    : elements(), width(-1), impl_type(ImplType::sequential) {}
+    : elements(), width(-1), 
+      impl_type(ImplType::sequential), combine_type(CombineType::general),
+      partitioned(false), part_first(0), part_last(0),
+      view(nullptr), view_bytes(0), view_mapped(false) {}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+void Reduce<ElemType,SeedType,InjectType>::set_partition(size_t first, size_t last) {
+    if (first > last) {
+        std::cerr << "Reduce::set_partition(): error: invalid partition [" << first << ", " << last << ")";
+        std::exit(EXIT_FAILURE);
+    }
+    partitioned = true;
+    part_first = first;
+    part_last = last;
+}
 
 template <typename ElemType, typename SeedType, typename InjectType>
 Reduce<ElemType,SeedType,InjectType>::~Reduce() {
+    unbind();
     width = -1;
     elements.clear();
 }
@@ -19,6 +34,19 @@ Reduce<ElemType,SeedType,InjectType>::Element::~Element() {}
 template <typename ElemType, typename SeedType, typename InjectType>
 Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::grow(size_t width) {
     
+    // growing own elements replaces any bound external data
+    unbind();
+    elements.clear();
+    // the index of the first element grown
+    size_t first = 0;
+    if (partitioned) {
+        if (part_last > width) {
+            std::cerr << "Reduce::grow(): error: the partition does not fit the width " << width;
+            std::exit(EXIT_FAILURE);
+        }
+        first = part_first;
+        width = part_last-part_first;
+    }
     // the width of the reduction
     this->width = width;
     // the vector container to hold all reduction elements
@@ -28,33 +56,30 @@ Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::grow
         for (size_t i=0; i<width; i++) {
             // position information 
             ElementInfo info;
-            info.index = i;
+            info.index = first+i;
             // allocate memory and set the position
-            std::unique_ptr<Element> elem(new ElemType(info));
+            ElementPtr elem = new_element(info);
             // grow custom part of the element
             elem->grow();
             // move the grown element into its position in the reduction
             elements.push_back(std::move(elem));
         }
     } else if (this->get_impl_type() == ImplType::parallel) {
-        size_t i;
-        int max_threads = omp_get_max_threads();
-        int threads_count = (width <= max_threads) ? width : max_threads;
-
         elements.resize(width);
 
-        #pragma omp parallel for private(i) shared(elements) num_threads(threads_count)
-        for (i=0; i<width; i++) {
-            // position information 
-            ElementInfo info;
-            info.index = i;
-            // allocate memory and set the position
-            std::unique_ptr<Element> elem(new ElemType(info));
-            // grow custom part of the element
-            elem->grow();
-            // move the grown element into its position in the reduction
-            elements[i] = std::move(elem);
-        }
+        this->executor(true).parallel_for(0, width, 1, [this,first](size_t begin, size_t end) {
+            for (size_t i=begin; i<end; i++) {
+                // position information 
+                ElementInfo info;
+                info.index = first+i;
+                // allocate memory and set the position
+                ElementPtr elem = new_element(info);
+                // grow custom part of the element
+                elem->grow();
+                // move the grown element into its position in the reduction
+                elements[i] = std::move(elem);
+            }
+        });
     }
 
     return *this;
@@ -63,6 +88,19 @@ Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::grow
 template <typename ElemType, typename SeedType, typename InjectType>
 Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::grow(size_t width, SeedType seed) {
     
+    // growing own elements replaces any bound external data
+    unbind();
+    elements.clear();
+    // the index of the first element grown
+    size_t first = 0;
+    if (partitioned) {
+        if (part_last > width) {
+            std::cerr << "Reduce::grow(): error: the partition does not fit the width " << width;
+            std::exit(EXIT_FAILURE);
+        }
+        first = part_first;
+        width = part_last-part_first;
+    }
     // the width of the reduction
     this->width = width;
     // the vector container to hold all reduction elements
@@ -72,33 +110,30 @@ Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::grow
         for (size_t i=0; i<width; i++) {
             // position information 
             ElementInfo info;
-            info.index = i;
+            info.index = first+i;
             // allocate memory and set the position
-            std::unique_ptr<Element> elem(new ElemType(info));
+            ElementPtr elem = new_element(info);
             // grow custom part of the element
             elem->grow(seed);
             // move the grown element into its position in the reduction
             elements.push_back(std::move(elem));
         }
     } else if (this->get_impl_type() == ImplType::parallel) {
-        size_t i;
-        int max_threads = omp_get_max_threads();
-        int threads_count = (width <= max_threads) ? width : max_threads;
-
         elements.resize(width);
 
-        #pragma omp parallel for private(i) shared(elements,seed) num_threads(threads_count)
-        for (i=0; i<width; i++) {
-            // position information 
-            ElementInfo info;
-            info.index = i;
-            // allocate memory and set the position
-            std::unique_ptr<Element> elem(new ElemType(info));
-            // grow custom part of the element
-            elem->grow(seed);
-            // move the grown element into its position in the reduction
-            elements[i] = std::move(elem);
-        }
+        this->executor(true).parallel_for(0, width, 1, [this,first,&seed](size_t begin, size_t end) {
+            for (size_t i=begin; i<end; i++) {
+                // position information 
+                ElementInfo info;
+                info.index = first+i;
+                // allocate memory and set the position
+                ElementPtr elem = new_element(info);
+                // grow custom part of the element
+                elem->grow(seed);
+                // move the grown element into its position in the reduction
+                elements[i] = std::move(elem);
+            }
+        });
     }
 
     return *this;
@@ -109,18 +144,102 @@ Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::inje
     // propagate the data to all reduce elements
     if (this->get_impl_type() == ImplType::sequential) {
         for (size_t i=0; i<width; i++) {
-            elements[i]->inject(data);
+            element_at(i).inject(data);
         }
     } else if (this->get_impl_type() == ImplType::parallel) {
-        size_t i;
-        int max_threads = omp_get_max_threads();
-        int threads_count = (width <= max_threads) ? width : max_threads;
+        this->executor(true).parallel_for(0, width, 1, [this,&data](size_t begin, size_t end) {
+            for (size_t i=begin; i<end; i++) {
+                element_at(i).inject(data);
+            }
+        });
+    }
 
-        #pragma omp parallel for private(i) shared(elements) num_threads(threads_count)
-        for (size_t i=0; i<width; i++) {
-            elements[i]->inject(data);
+    return *this;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::bind(ElemType* data, size_t width) {
+    
+    unbind();
+    elements.clear();
+
+    // elements are used in place, nothing is allocated or copied
+    this->view = data;
+    this->view_bytes = width*sizeof(ElemType);
+    this->view_mapped = false;
+    this->width = width;
+
+    return *this;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::map(const std::string& path, bool writable) {
+    
+    static_assert(std::is_trivially_copyable<ElemType>::value, 
+                  "Reduce::map(): element type must be trivially copyable to be mapped from a file");
+
+    unbind();
+    elements.clear();
+
+    int fd = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Reduce::map(): error: cannot open the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Reduce::map(): error: cannot stat the file " << path;
+        std::exit(EXIT_FAILURE);
+    }
+
+    size_t bytes = st.st_size;
+    if (bytes % sizeof(ElemType) != 0) {
+        std::cerr << "Reduce::map(): error: the size of the file " << path << " is not a multiple of the record size";
+        std::exit(EXIT_FAILURE);
+    }
+
+    void* addr = nullptr;
+    if (bytes > 0) {
+        // read-only mappings are private copy-on-write ones, so that
+        // inject() can still write into the elements without touching
+        // the file; writable mappings write through into the file
+        addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, 
+                    writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "Reduce::map(): error: cannot map the file " << path;
+            std::exit(EXIT_FAILURE);
         }
+        // compute() and inject() stream through the records
+        madvise(addr, bytes, MADV_SEQUENTIAL);
     }
+    // the mapping keeps its own reference to the file
+    close(fd);
+
+    this->view = static_cast<ElemType*>(addr);
+    this->view_bytes = bytes;
+    this->view_mapped = (addr != nullptr);
+    this->width = bytes/sizeof(ElemType);
+
+    return *this;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::unbind() {
+    
+    if (view_mapped) {
+        munmap(view, view_bytes);
+    }
+    
+    if (view != nullptr) {
+        width = -1;
+    }
+
+    view = nullptr;
+    view_bytes = 0;
+    view_mapped = false;
+
+    return *this;
 }
 
 /*
@@ -136,9 +255,62 @@ Reduce<ElemType,SeedType,InjectType>& Reduce<ComputeType,ElemType>::shrink(size_
     }
 }*/
 
+template <typename ElemType, typename SeedType, typename InjectType>
+MemoryUsage Reduce<ElemType,SeedType,InjectType>::memory_usage() const {
+
+    MemoryUsage usage;
+
+    if (view != nullptr) {
+        // bound data is not allocated by the reduction
+        usage.payload += static_cast<std::size_t>(width)*sizeof(ElemType);
+        return usage;
+    }
+
+    std::size_t n = elements.size();
+    usage.payload += n*(sizeof(ElemType)-sizeof(Element));
+    usage.structural += n*sizeof(Element);
+    for (const ElementPtr& elem : elements) {
+        // the resource set now may not be the one the element came from
+        usage.add_blocks(*elem.get_deleter().get_resource(), 1, sizeof(ElemType), alignof(ElemType));
+    }
+    usage.add_vector(&MemoryUsage::structural, elements);
+
+    return usage;
+}
+
 template <typename ElemType, typename SeedType, typename InjectType>
 template <typename ComputeType>
 ComputeType Reduce<ElemType,SeedType,InjectType>::compute(Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& compute_func) {
+    if (combine_type == CombineType::general) {
+        return this->template compute_general<ComputeType>(compute_func);
+    } else if (combine_type == CombineType::associative) {
+        return this->template compute_associative<ComputeType>(compute_func);
+    } else {
+        std::cerr << "Reduce::compute():error: correct combine type has not been specified!";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+std::future<Reduce<ElemType,SeedType,InjectType>&> Reduce<ElemType,SeedType,InjectType>::grow_async(size_t width) {
+    return this->run_async([this, width]() -> Reduce<ElemType,SeedType,InjectType>& { return grow(width); });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+std::future<Reduce<ElemType,SeedType,InjectType>&> Reduce<ElemType,SeedType,InjectType>::grow_async(size_t width, SeedType seed) {
+    return this->run_async([this, width, seed]() -> Reduce<ElemType,SeedType,InjectType>& { return grow(width, seed); });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+std::future<ComputeType> Reduce<ElemType,SeedType,InjectType>::compute_async(Reduce<ElemType,SeedType,InjectType>::ComputeFunction<ComputeType>& compute_func) {
+    ComputeFunction<ComputeType>* func = &compute_func;
+    return this->run_async([this, func]() { return this->template compute<ComputeType>(*func); });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+ComputeType Reduce<ElemType,SeedType,InjectType>::compute_general(ComputeFunction<ComputeType>& compute_func) {
     // compute reduced values from all 
     // the elements of the reduce framework
     // and store them in indexed vector
@@ -148,20 +320,645 @@ ComputeType Reduce<ElemType,SeedType,InjectType>::compute(Reduce<ElemType,SeedTy
     // reduced from all the elements
     if (this->get_impl_type() == ImplType::sequential) {
         for (size_t i=0; i<width; i++) {
-            rets[i] = compute_func((ElemType&)*static_cast<ElemType*>(elements[i].get()));
+            rets[i] = compute_func(element_at(i));
         }
     } else if (this->get_impl_type() == ImplType::parallel) {
-        size_t i;
-        int max_threads = omp_get_max_threads();
-        int threads_count = (width <= max_threads) ? width : max_threads;
-
-        #pragma omp parallel for private(i) shared(rets,elements) num_threads(threads_count)
-        for (i=0; i<width; i++) {
-            rets[i] = compute_func((ElemType&)*static_cast<ElemType*>(elements[i].get()));
-        }
+        this->executor(true).parallel_for(0, width, 1, [this,&rets,&compute_func](size_t begin, size_t end) {
+            for (size_t i=begin; i<end; i++) {
+                rets[i] = compute_func(element_at(i));
+            }
+        });
     }
     // call a user-defined function for a final reduction
     return compute_func(rets);
 }
 
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+ComputeType Reduce<ElemType,SeedType,InjectType>::compute_associative(ComputeFunction<ComputeType>& compute_func) {
+    auto element_at = [this](size_t i) -> ElemType& {
+        return this->element_at(i);
+    };
+    return this->template accumulate<ComputeType>(width, element_at, compute_func);
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+std::vector<ComputeType> Reduce<ElemType,SeedType,InjectType>::compute_batch(const std::vector<InjectType>& data, ComputeFunction<ComputeType>& compute_func) {
+    
+    size_t n = (width > 0) ? width : 0;
+    size_t batch_size = data.size();
+    
+    std::vector<ComputeType> rets(batch_size);
+    
+    if (n == 0 || batch_size == 0) {
+        return rets;
+    }
+
+    Executor& executor = this->executor(is_parallel());
+
+    if (combine_type == CombineType::general) {
+        // the values of all the elements for a group of inject values,
+        // reduced by the user-defined final reduction; the groups are
+        // bounded so the buffer does not grow with the batch
+        const size_t group_size = 16;
+        size_t groups_size = (batch_size < group_size) ? batch_size : group_size;
+        std::vector<std::vector<ComputeType>> values(groups_size, std::vector<ComputeType>(n));
+
+        for (size_t group_begin=0; group_begin<batch_size; group_begin+=group_size) {
+            size_t group_end = (group_begin+group_size < batch_size) ? group_begin+group_size : batch_size;
+
+            executor.parallel_for(0, n, 1, [&](size_t begin, size_t end) {
+                for (size_t i=begin; i<end; i++) {
+                    ElemType& elem = element_at(i);
+                    for (size_t k=group_begin; k<group_end; k++) {
+                        elem.inject(data[k]);
+                        values[k-group_begin][i] = compute_func(elem);
+                    }
+                }
+            });
+
+            for (size_t k=group_begin; k<group_end; k++) {
+                rets[k] = compute_func(values[k-group_begin]);
+            }
+        }
+
+        return rets;
+    }
+
+    if (combine_type != CombineType::associative) {
+        std::cerr << "Reduce::compute_batch():error: correct combine type has not been specified!";
+        std::exit(EXIT_FAILURE);
+    }
+
+    size_t threads_num = executor.concurrency();
+    size_t blocks_num = (n <= threads_num) ? n : threads_num;
+
+    // per-block partials of all the reductions in the batch
+    std::vector<std::vector<ComputeType>> partials(blocks_num, std::vector<ComputeType>(batch_size));
+
+    executor.parallel_for(0, blocks_num, 1, [&](size_t blocks_begin, size_t blocks_end) {
+        for (size_t b=blocks_begin; b<blocks_end; b++) {
+            size_t begin = (n*b)/blocks_num;
+            size_t end = (n*(b+1))/blocks_num;
+            std::vector<ComputeType>& block_partials = partials[b];
+            
+            // the first element of the block initializes the partials
+            ElemType& first = element_at(begin);
+            for (size_t k=0; k<batch_size; k++) {
+                first.inject(data[k]);
+                block_partials[k] = compute_func(first);
+            }
+            
+            for (size_t i=begin+1; i<end; i++) {
+                ElemType& elem = element_at(i);
+                for (size_t k=0; k<batch_size; k++) {
+                    elem.inject(data[k]);
+                    compute_func.accumulate(block_partials[k], elem);
+                }
+            }
+        }
+    });
+
+    // combine the partials of every reduction in the batch
+    // in block order; batch members are independent
+    executor.parallel_for(0, batch_size, 1, [&](size_t batch_begin, size_t batch_end) {
+        for (size_t k=batch_begin; k<batch_end; k++) {
+            std::vector<ComputeType> block_rets(blocks_num);
+            for (size_t b=0; b<blocks_num; b++) {
+                block_rets[b] = std::move(partials[b][k]);
+            }
+            rets[k] = this->template combine_tree<ComputeType>(block_rets, compute_func);
+        }
+    });
+
+    return rets;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType, typename ProducerFunc>
+ComputeType Reduce<ElemType,SeedType,InjectType>::compute_stream(ProducerFunc producer, size_t chunk_size, ComputeFunction<ComputeType>& compute_func) {
+    
+    if (chunk_size == 0) {
+        std::cerr << "Reduce::compute_stream(): error: chunk size cannot be zero";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // two chunk slots handed over between the producer thread, which
+    // fills them in turn, and the calling thread, which reduces them
+    struct Handoff {
+        std::vector<ElemType> chunks[2];
+        bool filled[2] = { false, false };
+        bool stop = false;
+        std::exception_ptr error;
+        std::mutex lock;
+        std::condition_variable changed;
+    } handoff;
+
+    handoff.chunks[0].reserve(chunk_size);
+    handoff.chunks[1].reserve(chunk_size);
+
+    std::thread producer_thread([&handoff, &producer, chunk_size]() {
+        for (int slot = 0; ; slot = 1-slot) {
+            {
+                std::unique_lock<std::mutex> guard(handoff.lock);
+                handoff.changed.wait(guard, [&]() { return handoff.stop || !handoff.filled[slot]; });
+                if (handoff.stop) {
+                    return;
+                }
+            }
+
+            std::vector<ElemType>& chunk = handoff.chunks[slot];
+            chunk.clear();
+            try {
+                producer(chunk, chunk_size);
+            } catch (...) {
+                // ends the stream with the error
+                chunk.clear();
+                handoff.error = std::current_exception();
+            }
+
+            bool last = chunk.empty();
+            {
+                std::lock_guard<std::mutex> guard(handoff.lock);
+                handoff.filled[slot] = true;
+            }
+            handoff.changed.notify_all();
+
+            if (last) {
+                return;
+            }
+        }
+    });
+
+    // stops and joins the producer however the reduction ends
+    struct Joiner {
+        Handoff& handoff;
+        std::thread& thread;
+        ~Joiner() {
+            {
+                std::lock_guard<std::mutex> guard(handoff.lock);
+                handoff.stop = true;
+            }
+            handoff.changed.notify_all();
+            thread.join();
+        }
+    } joiner { handoff, producer_thread };
+
+    ComputeType ret = ComputeType();
+    bool has_ret = false;
+
+    for (int slot = 0; ; slot = 1-slot) {
+        {
+            std::unique_lock<std::mutex> guard(handoff.lock);
+            handoff.changed.wait(guard, [&]() { return handoff.filled[slot]; });
+        }
+
+        // reduce the chunk and fold it into the running partial
+        std::vector<ElemType>& chunk = handoff.chunks[slot];
+        if (chunk.empty()) {
+            break;
+        }
+
+        auto element_at = [&chunk](size_t i) -> ElemType& {
+            return chunk[i];
+        };
+        ComputeType partial = this->template accumulate<ComputeType>(chunk.size(), element_at, compute_func);
+        
+        ret = has_ret ? compute_func.combine(ret, partial) : partial;
+        has_ret = true;
+
+        {
+            std::lock_guard<std::mutex> guard(handoff.lock);
+            handoff.filled[slot] = false;
+        }
+        handoff.changed.notify_all();
+    }
+
+    if (handoff.error) {
+        std::rethrow_exception(handoff.error);
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename KeyType, typename ComputeType, typename KeyFunc>
+typename Reduce<ElemType,SeedType,InjectType>::template Groups<KeyType,ComputeType> Reduce<ElemType,SeedType,InjectType>::compute_grouped(KeyFunc key_func, ComputeFunction<ComputeType>& compute_func) {
+    
+    using Table_t = std::unordered_map<KeyType,ComputeType>;
+    
+    size_t n = (width > 0) ? width : 0;
+    
+    Executor& executor = this->executor(is_parallel());
+
+    int threads_num = executor.concurrency();
+    int blocks_num = (n <= threads_num) ? ((n > 0) ? n : 1) : threads_num;
+    int parts_num = blocks_num;
+    
+    auto partition_of = [parts_num](const KeyType& key) -> int {
+        return Groups<KeyType,ComputeType>::partition_of(key, parts_num);
+    };
+
+    // thread-local hash tables: tables[block][partition]
+    std::vector<std::vector<Table_t>> tables(blocks_num, std::vector<Table_t>(parts_num));
+
+    executor.parallel_for(0, blocks_num, 1, [&](size_t blocks_begin, size_t blocks_end) {
+        for (size_t b=blocks_begin; b<blocks_end; b++) {
+            size_t begin = (n*b)/blocks_num;
+            size_t end = (n*(b+1))/blocks_num;
+            for (size_t i=begin; i<end; i++) {
+                ElemType& elem = element_at(i);
+                KeyType key = key_func(elem);
+                Table_t& table = tables[b][partition_of(key)];
+                auto it = table.find(key);
+                if (it == table.end()) {
+                    table.emplace(key, compute_func(elem));
+                } else {
+                    compute_func.accumulate(it->second, elem);
+                }
+            }
+        }
+    });
+
+    // parallel partitioned merge: every partition is merged 
+    // independently from the tables of all the blocks
+    Groups<KeyType,ComputeType> ret(parts_num);
+    std::vector<Table_t>& merged = ret.parts;
+
+    executor.parallel_for(0, parts_num, 1, [&](size_t parts_begin, size_t parts_end) {
+        for (size_t p=parts_begin; p<parts_end; p++) {
+            Table_t& part = merged[p];
+            part = std::move(tables[0][p]);
+            for (int b=1; b<blocks_num; b++) {
+                for (auto& kv : tables[b][p]) {
+                    auto it = part.find(kv.first);
+                    if (it == part.end()) {
+                        part.emplace(kv.first, std::move(kv.second));
+                    } else {
+                        it->second = compute_func.combine(it->second, kv.second);
+                    }
+                }
+                Table_t().swap(tables[b][p]);
+            }
+        }
+    });
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType, typename AccessFunc>
+ComputeType Reduce<ElemType,SeedType,InjectType>::accumulate(size_t n, AccessFunc element_at, ComputeFunction<ComputeType>& compute_func) {
+    
+    if (n == 0) {
+        return ComputeType();
+    }
+
+    if (this->get_impl_type() == ImplType::sequential) {
+        ComputeType partial = compute_func(element_at(0));
+        for (size_t i=1; i<n; i++) {
+            compute_func.accumulate(partial, element_at(i));
+        }
+        return partial;
+    } 
+
+    // split the elements into contiguous blocks, one per thread;
+    // the blocks depend only on the concurrency of the executor,
+    // so the result is deterministic for a fixed threads count
+    Executor& executor = this->executor(true);
+
+    size_t threads_num = executor.concurrency();
+    size_t blocks_num = (n <= threads_num) ? n : threads_num;
+    
+    std::vector<ComputeType> partials(blocks_num);
+
+    executor.parallel_for(0, blocks_num, 1, [&](size_t blocks_begin, size_t blocks_end) {
+        for (size_t b=blocks_begin; b<blocks_end; b++) {
+            size_t begin = (n*b)/blocks_num;
+            size_t end = (n*(b+1))/blocks_num;
+            // thread-local accumulation into a private partial
+            ComputeType partial = compute_func(element_at(begin));
+            for (size_t i=begin+1; i<end; i++) {
+                compute_func.accumulate(partial, element_at(i));
+            }
+            partials[b] = std::move(partial);
+        }
+    });
+
+    return this->template combine_tree<ComputeType>(partials, compute_func);
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+ComputeType Reduce<ElemType,SeedType,InjectType>::combine_tree(std::vector<ComputeType>& partials, ComputeFunction<ComputeType>& compute_func) {
+    
+    size_t n = partials.size();
+    
+    if (n == 0) {
+        return ComputeType();
+    }
+
+    // at every step combine the neighbouring pairs of partials
+    // [i, i+stride] into i; the shape of the tree depends only 
+    // on the number of partials
+    Executor& executor = this->executor(is_parallel());
+
+    for (size_t stride=1; stride<n; stride*=2) {
+        size_t pairs_num = (n-stride+2*stride-1)/(2*stride);
+
+        executor.parallel_for(0, pairs_num, 1, [&](size_t pairs_begin, size_t pairs_end) {
+            for (size_t p=pairs_begin; p<pairs_end; p++) {
+                size_t left = 2*stride*p;
+                size_t right = left+stride;
+                partials[left] = compute_func.combine(partials[left], partials[right]);
+            }
+        });
+    }
+
+    return partials[0];
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+typename Reduce<ElemType,SeedType,InjectType>::template Column<FieldType> Reduce<ElemType,SeedType,InjectType>::gather(FieldType ElemType::* field) {
+    
+    Column<FieldType> col((width > 0) ? width : 0, impl_type);
+    FieldType* values = col.data();
+
+    if (this->get_impl_type() == ImplType::sequential) {
+        for (size_t i=0; i<col.size(); i++) {
+            values[i] = element_at(i).*field;
+        }
+    } else if (this->get_impl_type() == ImplType::parallel) {
+        this->executor(true).parallel_for(0, col.size(), 1024, [&](size_t begin, size_t end) {
+            for (size_t i=begin; i<end; i++) {
+                values[i] = element_at(i).*field;
+            }
+        });
+    }
+
+    return col;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+Reduce<ElemType,SeedType,InjectType>& Reduce<ElemType,SeedType,InjectType>::scatter(const Column<FieldType>& col, FieldType ElemType::* field) {
+    
+    if (col.size() != (size_t)((width > 0) ? width : 0)) {
+        std::cerr << "Reduce::scatter(): error: column size does not match the width of the reduction";
+        std::exit(EXIT_FAILURE);
+    }
+
+    const FieldType* values = col.data();
+
+    if (this->get_impl_type() == ImplType::sequential) {
+        for (size_t i=0; i<col.size(); i++) {
+            element_at(i).*field = values[i];
+        }
+    } else if (this->get_impl_type() == ImplType::parallel) {
+        this->executor(true).parallel_for(0, col.size(), 1024, [&](size_t begin, size_t end) {
+            for (size_t i=begin; i<end; i++) {
+                element_at(i).*field = values[i];
+            }
+        });
+    }
+
+    return *this;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+FieldType Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::sum() const {
+    const FieldType* v = values.data();
+    size_t n = values.size();
+    FieldType ret = FieldType();
+
+    #pragma omp parallel for simd reduction(+:ret) if(parallel: is_parallel())
+    for (size_t i=0; i<n; i++) {
+        ret += v[i];
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+FieldType Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::min() const {
+    check_not_empty("min");
+    
+    const FieldType* v = values.data();
+    size_t n = values.size();
+    FieldType ret = v[0];
+
+    #pragma omp parallel for simd reduction(min:ret) if(parallel: is_parallel())
+    for (size_t i=1; i<n; i++) {
+        ret = (v[i] < ret) ? v[i] : ret;
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+FieldType Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::max() const {
+    check_not_empty("max");
+    
+    const FieldType* v = values.data();
+    size_t n = values.size();
+    FieldType ret = v[0];
+
+    #pragma omp parallel for simd reduction(max:ret) if(parallel: is_parallel())
+    for (size_t i=1; i<n; i++) {
+        ret = (v[i] > ret) ? v[i] : ret;
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+template <typename Precedes>
+size_t Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::find_extreme(Precedes precedes) const {
+    const FieldType* v = values.data();
+    size_t n = values.size();
+    
+    FieldType best = v[0];
+    size_t ret = 0;
+
+    // every thread tracks the value and the index of its own
+    // contiguous range; the ranges are merged keeping the first
+    // index among equal values
+    #pragma omp parallel if(is_parallel())
+    {
+        FieldType local_best = v[0];
+        size_t local_ret = n;
+
+        #pragma omp for schedule(static) nowait
+        for (size_t i=0; i<n; i++) {
+            if (local_ret == n || precedes(v[i], local_best)) {
+                local_best = v[i];
+                local_ret = i;
+            }
+        }
+
+        #pragma omp critical
+        if (local_ret < n) {
+            if (precedes(local_best, best) || (!precedes(best, local_best) && local_ret < ret)) {
+                best = local_best;
+                ret = local_ret;
+            }
+        }
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+size_t Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::argmin() const {
+    check_not_empty("argmin");
+    return find_extreme([](FieldType a, FieldType b) {
+        return is_nan(a) ? !is_nan(b) : (a < b);
+    });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+size_t Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::argmax() const {
+    check_not_empty("argmax");
+    return find_extreme([](FieldType a, FieldType b) {
+        return is_nan(a) ? !is_nan(b) : (a > b);
+    });
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+FieldType Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::dot(const Column<FieldType>& other) const {
+    
+    if (other.size() != values.size()) {
+        std::cerr << "Reduce::Column::dot(): error: columns of different sizes";
+        std::exit(EXIT_FAILURE);
+    }
+    
+    const FieldType* v = values.data();
+    const FieldType* u = other.data();
+    size_t n = values.size();
+    FieldType ret = FieldType();
+
+    #pragma omp parallel for simd reduction(+:ret) if(parallel: is_parallel())
+    for (size_t i=0; i<n; i++) {
+        ret += v[i]*u[i];
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename FieldType>
+template <typename Predicate>
+size_t Reduce<ElemType,SeedType,InjectType>::Column<FieldType>::count_if(Predicate pred) const {
+    const FieldType* v = values.data();
+    size_t n = values.size();
+    size_t ret = 0;
+
+    #pragma omp parallel for simd reduction(+:ret) if(parallel: is_parallel())
+    for (size_t i=0; i<n; i++) {
+        ret += pred(v[i]) ? 1 : 0;
+    }
+
+    return ret;
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+typename Reduce<ElemType,SeedType,InjectType>::template RangeIndex<ComputeType> Reduce<ElemType,SeedType,InjectType>::build_index(ComputeFunction<ComputeType>& compute_func) {
+    return RangeIndex<ComputeType>(*this, compute_func);
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+Reduce<ElemType,SeedType,InjectType>::RangeIndex<ComputeType>::RangeIndex(Reduce<ElemType,SeedType,InjectType>& reduce, ComputeFunction<ComputeType>& func)
+    : reduce(&reduce), compute_func(&func), width((reduce.width > 0) ? reduce.width : 0), tree(2*width) 
+{
+    Executor& executor = reduce.executor(reduce.is_parallel());
+    
+    // leaves
+    executor.parallel_for(0, width, 1, [&](size_t begin, size_t end) {
+        for (size_t i=begin; i<end; i++) {
+            tree[width+i] = func(reduce.element_at(i));
+        }
+    });
+
+    // inner nodes level by level; the children of the nodes
+    // in [lo, hi) all lie at or above hi
+    size_t hi = width;
+    while (hi > 1) {
+        size_t lo = (hi+1)/2;
+        
+        executor.parallel_for(lo, hi, 1, [&](size_t begin, size_t end) {
+            for (size_t p=begin; p<end; p++) {
+                tree[p] = func.combine(tree[2*p], tree[2*p+1]);
+            }
+        });
+        
+        hi = lo;
+    }
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+ComputeType Reduce<ElemType,SeedType,InjectType>::RangeIndex<ComputeType>::query(size_t begin, size_t end) const {
+    
+    if (begin > end || end > width) {
+        std::cerr << "Reduce::RangeIndex::query(): error: invalid range";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // left and right partials are accumulated separately, 
+    // so the order of the operands is preserved
+    ComputeType left, right;
+    bool has_left = false, has_right = false;
+
+    for (size_t l = begin+width, r = end+width; l < r; l /= 2, r /= 2) {
+        if (l & 1) {
+            left = has_left ? compute_func->combine(left, tree[l]) : tree[l];
+            has_left = true;
+            l++;
+        }
+        if (r & 1) {
+            r--;
+            right = has_right ? compute_func->combine(tree[r], right) : tree[r];
+            has_right = true;
+        }
+    }
+
+    if (has_left && has_right) {
+        return compute_func->combine(left, right);
+    } else if (has_left) {
+        return left;
+    } else if (has_right) {
+        return right;
+    } else {
+        return ComputeType();
+    }
+}
+
+template <typename ElemType, typename SeedType, typename InjectType>
+template <typename ComputeType>
+void Reduce<ElemType,SeedType,InjectType>::RangeIndex<ComputeType>::update(size_t i) {
+    
+    if (i >= width) {
+        std::cerr << "Reduce::RangeIndex::update(): error: element index out of range";
+        std::exit(EXIT_FAILURE);
+    }
+
+    size_t p = width+i;
+    tree[p] = (*compute_func)(reduce->element_at(i));
+    
+    for (p /= 2; p >= 1; p /= 2) {
+        tree[p] = compute_func->combine(tree[2*p], tree[2*p+1]);
+    }
+}
+
 //
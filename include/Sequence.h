@@ -3,16 +3,25 @@
 
 #include <cstdlib>
 
+#include <new>
 #include <vector>
+#include <memory>
 #include <utility>
+#include <stdexcept>
+#include <iterator>
+#include <omp.h>
 
 #include <Collection.h>
+#include "Pipeline.h"
 
 namespace abstract {
 
 template <typename ElemType>
 class Sequence : public Collection<ElemType> {
 
+    template <typename, typename>
+    friend class Pipeline;
+
     public:    
         
         Sequence();
@@ -33,9 +42,19 @@ class Sequence : public Collection<ElemType> {
         void add(ElemType elem);
         ElemType& at(std::size_t i);
 
+        ElemType* data() { return _vec.data(); }
+        const ElemType* data() const { return _vec.data(); }
+
         template<typename MapFunc>
         void map(MapFunc map_func);
 
+        // lazy pipeline over the elements of the sequence; chains of
+        // map() and filter() stages are fused into a single parallel 
+        // pass by a terminal operation, see Pipeline.h
+        Pipeline<ElemType,PipelineSource<ElemType>> lazy() const {
+            return Pipeline<ElemType,PipelineSource<ElemType>>(_vec.data(), _vec.size(), PipelineSource<ElemType>());
+        }
+
         template<typename OutputStream>
         void print(OutputStream& out_stream);
 
@@ -43,6 +62,63 @@ class Sequence : public Collection<ElemType> {
         std::vector<ElemType> _vec;
 };
 
+// InlineSequence class
+//
+// Sequence with inline capacity: the first InlineCapacity elements are
+// stored inside the object itself and never allocate; elements beyond
+// that spill over into a heap-allocated vector
+//
+template <typename ElemType, std::size_t InlineCapacity>
+class InlineSequence : public Collection<ElemType> {
+
+    public:
+        
+        InlineSequence();
+        InlineSequence(const InlineSequence& seq);
+        InlineSequence(InlineSequence&& seq);
+        ~InlineSequence();
+
+        InlineSequence& operator=(const InlineSequence& seq);
+        InlineSequence& operator=(InlineSequence&& seq);
+
+        ElemType& operator[](const int i) { 
+            return (static_cast<std::size_t>(i) < InlineCapacity) ? inline_data()[i] : (*_spill)[i-InlineCapacity]; 
+        }
+
+        const ElemType& operator[](const int i) const { return get(i); }
+
+        // primitive operations
+        std::size_t size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        void add(ElemType elem);
+        ElemType& at(std::size_t i);
+        
+        void clear();
+
+        template<typename MapFunc>
+        void map(MapFunc map_func);
+
+        template<typename OutputStream>
+        void print(OutputStream& out_stream);
+
+    protected:
+        
+        ElemType* inline_data() { return reinterpret_cast<ElemType*>(_buf); }
+        const ElemType* inline_data() const { return reinterpret_cast<const ElemType*>(_buf); }
+
+        const ElemType& get(std::size_t i) const { 
+            return (i < InlineCapacity) ? inline_data()[i] : (*_spill)[i-InlineCapacity]; 
+        }
+
+    protected:
+        
+        alignas(ElemType) unsigned char _buf[(InlineCapacity > 0 ? InlineCapacity : 1)*sizeof(ElemType)];
+        std::size_t _size;
+        std::unique_ptr<std::vector<ElemType>> _spill;
+};
+
 template <typename ElemType>
 class MonotonicSequence : public Sequence<ElemType> {
 
@@ -50,6 +126,116 @@ class MonotonicSequence : public Sequence<ElemType> {
         
         template <typename TransFunc>
         MonotonicSequence(ElemType seed, std::size_t size, TransFunc trans_func);
+
+        // parallel fill for transformations which support jump-ahead:
+        // jump_func(seed, n) must return the n-th element, i.e. the seed
+        // transformed n times. Every thread jumps to the start of its 
+        // own block and generates the block with trans_func
+        template <typename TransFunc, typename JumpFunc>
+        MonotonicSequence(ElemType seed, std::size_t size, TransFunc trans_func, JumpFunc jump_func);
+};
+
+// LazyMonotonicSequence class
+//
+// Generator view of a monotonic sequence: elements are produced on
+// demand from the seed with trans_func and are never stored. Iteration
+// and increasing at() accesses cost one transformation per element
+//
+template <typename ElemType, typename TransFunc>
+class LazyMonotonicSequence {
+
+    public:
+
+        class iterator;
+
+        LazyMonotonicSequence(ElemType seed, std::size_t size, TransFunc trans_func)
+            : seed(seed), _size(size), trans_func(trans_func), cursor(seed), cursor_index(0) {}
+
+        std::size_t size() const { return _size; }
+
+        bool empty() const { return _size == 0; }
+
+        // i-th element; generated forward from the last accessed
+        // element or from the seed if i lies behind it
+        ElemType at(std::size_t i);
+
+        iterator begin() const { return iterator(this, seed, 0); }
+        iterator end() const { return iterator(this, seed, _size); }
+
+    private:
+
+        ElemType seed;
+        std::size_t _size;
+        TransFunc trans_func;
+
+        // last accessed element
+        ElemType cursor;
+        std::size_t cursor_index;
+};
+
+template <typename ElemType, typename TransFunc>
+class LazyMonotonicSequence<ElemType,TransFunc>::iterator {
+
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ElemType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElemType*;
+        using reference = const ElemType&;
+
+        iterator(const LazyMonotonicSequence<ElemType,TransFunc>* seq, ElemType value, std::size_t index)
+            : seq(seq), value(value), index(index) {}
+
+        const ElemType& operator*() const { return value; }
+        const ElemType* operator->() const { return &value; }
+
+        iterator& operator++() {
+            if (++index < seq->_size) {
+                value = seq->trans_func(value);
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& it) const { return index == it.index; }
+        bool operator!=(const iterator& it) const { return index != it.index; }
+
+    private:
+
+        const LazyMonotonicSequence<ElemType,TransFunc>* seq;
+        ElemType value;
+        std::size_t index;
+};
+
+template <typename ElemType, typename TransFunc>
+LazyMonotonicSequence<ElemType,TransFunc> make_lazy_monotonic(ElemType seed, std::size_t size, TransFunc trans_func) {
+    return LazyMonotonicSequence<ElemType,TransFunc>(seed, size, trans_func);
+}
+
+// AffineTransform class
+//
+// Transformation x -> a*x+b with jump-ahead by composition: applying 
+// it n times is again an affine map, computed in O(log n) steps. Covers
+// arithmetic and geometric progressions and linear congruential RNG
+// steps (with unsigned wrap-around arithmetic)
+//
+template <typename ElemType>
+class AffineTransform {
+
+    public:
+
+        AffineTransform(ElemType a, ElemType b)
+            : a(a), b(b) {}
+
+        ElemType operator()(const ElemType& x) const { return a*x+b; }
+
+        // x transformed n times
+        ElemType jump(const ElemType& x, std::size_t n) const;
+
+    private:
+
+        ElemType a;
+        ElemType b;
 };
 
 #include "Sequence.tpp"
@@ -61,6 +61,109 @@ void Sequence<ElemType>::print(OutputStream& out_stream) {
     }
 }
 
+template <typename ElemType, std::size_t InlineCapacity>
+InlineSequence<ElemType,InlineCapacity>::InlineSequence()
+    : _size(0), _spill(nullptr) {}
+
+template <typename ElemType, std::size_t InlineCapacity>
+InlineSequence<ElemType,InlineCapacity>::InlineSequence(const InlineSequence& seq)
+    : _size(0), _spill(nullptr)
+{
+    for (std::size_t i=0; i<seq.size(); i++) {
+        add(seq.get(i));
+    }
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+InlineSequence<ElemType,InlineCapacity>::InlineSequence(InlineSequence&& seq)
+    : _size(0), _spill(std::move(seq._spill))
+{
+    std::size_t inline_size = (seq._size < InlineCapacity) ? seq._size : InlineCapacity;
+    for (std::size_t i=0; i<inline_size; i++) {
+        new (inline_data()+i) ElemType(std::move(seq.inline_data()[i]));
+    }
+    _size = seq._size;
+    seq.clear();
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+InlineSequence<ElemType,InlineCapacity>::~InlineSequence() {
+    clear();
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+InlineSequence<ElemType,InlineCapacity>& InlineSequence<ElemType,InlineCapacity>::operator=(const InlineSequence& seq) {
+    if (this != &seq) {
+        clear();
+        for (std::size_t i=0; i<seq.size(); i++) {
+            add(seq.get(i));
+        }
+    }
+    return *this;
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+InlineSequence<ElemType,InlineCapacity>& InlineSequence<ElemType,InlineCapacity>::operator=(InlineSequence&& seq) {
+    if (this != &seq) {
+        clear();
+        std::size_t inline_size = (seq._size < InlineCapacity) ? seq._size : InlineCapacity;
+        for (std::size_t i=0; i<inline_size; i++) {
+            new (inline_data()+i) ElemType(std::move(seq.inline_data()[i]));
+        }
+        _spill = std::move(seq._spill);
+        _size = seq._size;
+        seq.clear();
+    }
+    return *this;
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+void InlineSequence<ElemType,InlineCapacity>::add(ElemType elem) {
+    if (_size < InlineCapacity) {
+        new (inline_data()+_size) ElemType(std::move(elem));
+    } else {
+        if (_spill == nullptr) {
+            _spill.reset(new std::vector<ElemType>());
+        }
+        _spill->push_back(std::move(elem));
+    }
+    _size++;
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+ElemType& InlineSequence<ElemType,InlineCapacity>::at(std::size_t i) {
+    if (i >= _size) {
+        throw std::out_of_range("InlineSequence::at(): index out of range");
+    }
+    return (*this)[i];
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+void InlineSequence<ElemType,InlineCapacity>::clear() {
+    std::size_t inline_size = (_size < InlineCapacity) ? _size : InlineCapacity;
+    for (std::size_t i=0; i<inline_size; i++) {
+        inline_data()[i].~ElemType();
+    }
+    _spill.reset();
+    _size = 0;
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+template <typename MapFunc>
+void InlineSequence<ElemType,InlineCapacity>::map(MapFunc map_func) {
+    for (std::size_t i=0; i<_size; i++) {
+        (*this)[i] = map_func((*this)[i]);
+    }
+}
+
+template <typename ElemType, std::size_t InlineCapacity>
+template <typename OutputStream>
+void InlineSequence<ElemType,InlineCapacity>::print(OutputStream& out_stream) {
+    for (std::size_t i=0; i<_size; i++) {
+        out_stream << (*this)[i];
+    }
+}
+
 template <typename ElemType>
 template <typename TransFunc>
 MonotonicSequence<ElemType>::MonotonicSequence(ElemType seed, std::size_t size, TransFunc trans_func) 
@@ -72,3 +175,65 @@ MonotonicSequence<ElemType>::MonotonicSequence(ElemType seed, std::size_t size,
         this->add(trans_func(prev)); 
     }
 }
+
+template <typename ElemType>
+template <typename TransFunc, typename JumpFunc>
+MonotonicSequence<ElemType>::MonotonicSequence(ElemType seed, std::size_t size, TransFunc trans_func, JumpFunc jump_func) 
+    : Sequence<ElemType>(size)
+{
+    this->_vec.resize(size);
+    
+    if (size == 0) {
+        return;
+    }
+
+    int max_threads = omp_get_max_threads();
+    int blocks_num = (size <= static_cast<std::size_t>(max_threads)) ? size : max_threads;
+    
+    #pragma omp parallel for schedule(static) num_threads(blocks_num)
+    for (int b=0; b<blocks_num; b++) {
+        std::size_t begin = (size*b)/blocks_num;
+        std::size_t end = (size*(b+1))/blocks_num;
+        // jump to the block seed
+        ElemType elem = (begin == 0) ? seed : jump_func(seed, begin);
+        this->_vec[begin] = elem;
+        for (std::size_t i=begin+1; i<end; i++) {
+            elem = trans_func(elem);
+            this->_vec[i] = elem;
+        }
+    }
+}
+
+template <typename ElemType, typename TransFunc>
+ElemType LazyMonotonicSequence<ElemType,TransFunc>::at(std::size_t i) {
+    if (i >= _size) {
+        throw std::out_of_range("LazyMonotonicSequence::at(): index out of range");
+    }
+    if (i < cursor_index) {
+        cursor = seed;
+        cursor_index = 0;
+    }
+    while (cursor_index < i) {
+        cursor = trans_func(cursor);
+        cursor_index++;
+    }
+    return cursor;
+}
+
+template <typename ElemType>
+ElemType AffineTransform<ElemType>::jump(const ElemType& x, std::size_t n) const {
+    // (a,b)^n by squaring: composing x -> a1*x+b1 after 
+    // x -> a2*x+b2 gives x -> a1*a2*x + a1*b2+b1
+    ElemType ret_a = 1, ret_b = 0;
+    ElemType pow_a = a, pow_b = b;
+    while (n > 0) {
+        if (n & 1) {
+            ret_b = pow_a*ret_b+pow_b;
+            ret_a = pow_a*ret_a;
+        }
+        pow_b = pow_a*pow_b+pow_b;
+        pow_a = pow_a*pow_a;
+        n >>= 1;
+    }
+    return ret_a*x+ret_b;
+}
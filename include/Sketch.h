@@ -0,0 +1,321 @@
+#ifndef ABSTRACT_SKETCH_H
+#define ABSTRACT_SKETCH_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <iostream>
+
+namespace abstract {
+
+//
+// Mergeable approximate sketches
+//
+// Constant-memory summaries of a stream of values, which can be merged
+// with each other. Used as the ComputeType of the Reduce sketch compute
+// functions below: every thread accumulates its block of elements into
+// its own sketch and the thread-local sketches are merged at the end
+//
+
+// mix the bits of a 64-bit value (splitmix64 finalizer)
+inline uint64_t sketch_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// well-mixed 64-bit hash of a value
+template <typename ValueType>
+uint64_t sketch_hash(const ValueType& value) {
+    return sketch_mix(static_cast<uint64_t>(std::hash<ValueType>()(value)));
+}
+
+// HyperLogLog class
+//
+// distinct count estimation with 2^precision one-byte registers
+//
+// ERROR BOUND: the relative standard error of estimate() is
+// 1.04/sqrt(2^precision), e.g. 0.81% for the default precision 14
+// (16 KB of registers); merging does not add any error
+//
+class HyperLogLog {
+
+    public:
+
+        HyperLogLog(int precision = 14);
+
+        // insert a value by its 64-bit hash, see sketch_hash()
+        void insert_hash(uint64_t hash);
+
+        HyperLogLog& merge(const HyperLogLog& other);
+        HyperLogLog& operator+=(const HyperLogLog& other) { return merge(other); }
+
+        // estimated number of distinct values inserted
+        double estimate() const;
+
+        int get_precision() const { return precision; }
+
+    private:
+
+        int precision;
+        std::vector<uint8_t> registers;
+};
+
+// KLLSketch class
+//
+// quantile estimation with a hierarchy of compactors (Karnin, Lang,
+// Liberty), whose capacities decrease geometrically from the top level
+// down; every compaction sorts a level and promotes every other item
+// with a doubled weight to the level above
+//
+// ERROR BOUND: the normalized rank error of rank() and quantile() is
+// within roughly 340/k percent with high probability, i.e. under 1% for
+// the default k = 400; it does not grow with merging. Memory is O(k)
+// values regardless of the stream length, so k = 200 halves it at
+// ~1.7% error
+//
+template <typename ValueType>
+class KLLSketch {
+
+    public:
+
+        KLLSketch(int k = 400);
+
+        void insert(const ValueType& value);
+
+        KLLSketch<ValueType>& merge(const KLLSketch<ValueType>& other);
+        KLLSketch<ValueType>& operator+=(const KLLSketch<ValueType>& other) { return merge(other); }
+
+        // number of values inserted
+        uint64_t count() const { return n; }
+
+        // estimated fraction of the values less or equal to value
+        double rank(const ValueType& value) const;
+
+        // estimated value of the q-th quantile, q in [0,1]
+        ValueType quantile(double q) const;
+
+    private:
+
+        size_t capacity(size_t level) const;
+        void compress();
+        void compact(size_t level);
+
+    private:
+
+        int k;
+        uint64_t n;
+        // deterministic coin for the offsets of compactions
+        uint64_t coin;
+        // items of the level h have the weight of 2^h
+        std::vector<std::vector<ValueType>> levels;
+};
+
+// SpaceSaving class
+//
+// top-k heavy hitters with a fixed number of counters (Metwally et al.);
+// when all counters are taken, a new key replaces the key with the
+// smallest count and inherits that count as its error. merge() adds up
+// the counts of the keys both summaries track; a key tracked by one of
+// them only gets the smallest count of the other one added to its count
+// and its error (the most it could have had there), and the m largest
+// counters are kept (the parallel Space Saving of Cafaro et al.)
+//
+// ERROR BOUND: with m counters and a total inserted count N, the count
+// of every tracked key is overestimated by at most N/m and every key
+// with a true count above N/m is tracked, also after merging
+//
+template <typename KeyType>
+class SpaceSaving {
+
+    public:
+
+        struct Counter {
+            KeyType key;
+            uint64_t count;
+            uint64_t error;
+        };
+
+        SpaceSaving(size_t capacity = 1024);
+
+        void insert(const KeyType& key, uint64_t count = 1);
+
+        SpaceSaving<KeyType>& merge(const SpaceSaving<KeyType>& other);
+        SpaceSaving<KeyType>& operator+=(const SpaceSaving<KeyType>& other) { return merge(other); }
+
+        // total count inserted
+        uint64_t count() const { return total; }
+
+        // the k keys with the largest estimated counts, largest first
+        std::vector<Counter> top(size_t k) const;
+
+        // estimated count of a key (0 if it is not tracked)
+        uint64_t estimate(const KeyType& key) const;
+
+        size_t get_capacity() const { return capacity; }
+
+    private:
+
+        // the smallest tracked count, or 0 while counters are free
+        uint64_t min_count() const;
+
+        // indexed min-heap of counters ordered by count
+        void sift_up(size_t i);
+        void sift_down(size_t i);
+        void swap_counters(size_t i, size_t j);
+
+    private:
+
+        size_t capacity;
+        uint64_t total;
+        std::vector<Counter> heap;
+        std::unordered_map<KeyType,size_t> positions;
+};
+
+//
+// Sketch compute functions
+//
+// Reduce compute functions, which reduce elements into sketches. Users
+// derive from them and specify which value of an element is sketched.
+// They update the thread-local sketches in place through accumulate(),
+// so they are meant to be used with the associative combine type
+//
+
+template <typename ReduceType>
+class DistinctCountFunction : public ReduceType::template ComputeFunction<HyperLogLog> {
+
+    public:
+
+        using Element_t = typename ReduceType::Element_t;
+
+        DistinctCountFunction(int precision = 14)
+            : precision(precision) {}
+
+        // 64-bit hash of the counted value of the element
+        virtual uint64_t hash(Element_t& element) = 0;
+
+        HyperLogLog operator()(Element_t& element) override {
+            HyperLogLog ret(precision);
+            ret.insert_hash(hash(element));
+            return ret;
+        }
+
+        HyperLogLog operator()(std::vector<HyperLogLog>& rets) override {
+            HyperLogLog ret(precision);
+            for (auto it = rets.begin(); it != rets.end(); it++) {
+                ret.merge(*it);
+            }
+            return ret;
+        }
+
+        HyperLogLog combine(const HyperLogLog& lhs, const HyperLogLog& rhs) override {
+            HyperLogLog ret = lhs;
+            return ret.merge(rhs);
+        }
+
+        void accumulate(HyperLogLog& partial, Element_t& element) override {
+            partial.insert_hash(hash(element));
+        }
+
+    private:
+
+        int precision;
+};
+
+template <typename ReduceType, typename ValueType>
+class QuantileFunction : public ReduceType::template ComputeFunction<KLLSketch<ValueType>> {
+
+    public:
+
+        using Element_t = typename ReduceType::Element_t;
+        using Sketch_t = KLLSketch<ValueType>;
+
+        QuantileFunction(int k = 400)
+            : k(k) {}
+
+        // the value of the element to be sketched
+        virtual ValueType value(Element_t& element) = 0;
+
+        Sketch_t operator()(Element_t& element) override {
+            Sketch_t ret(k);
+            ret.insert(value(element));
+            return ret;
+        }
+
+        Sketch_t operator()(std::vector<Sketch_t>& rets) override {
+            Sketch_t ret(k);
+            for (auto it = rets.begin(); it != rets.end(); it++) {
+                ret.merge(*it);
+            }
+            return ret;
+        }
+
+        Sketch_t combine(const Sketch_t& lhs, const Sketch_t& rhs) override {
+            Sketch_t ret = lhs;
+            return ret.merge(rhs);
+        }
+
+        void accumulate(Sketch_t& partial, Element_t& element) override {
+            partial.insert(value(element));
+        }
+
+    private:
+
+        int k;
+};
+
+template <typename ReduceType, typename KeyType>
+class TopKFunction : public ReduceType::template ComputeFunction<SpaceSaving<KeyType>> {
+
+    public:
+
+        using Element_t = typename ReduceType::Element_t;
+        using Sketch_t = SpaceSaving<KeyType>;
+
+        TopKFunction(size_t capacity = 1024)
+            : capacity(capacity) {}
+
+        // the key of the element to be counted
+        virtual KeyType key(Element_t& element) = 0;
+
+        Sketch_t operator()(Element_t& element) override {
+            Sketch_t ret(capacity);
+            ret.insert(key(element));
+            return ret;
+        }
+
+        Sketch_t operator()(std::vector<Sketch_t>& rets) override {
+            Sketch_t ret(capacity);
+            for (auto it = rets.begin(); it != rets.end(); it++) {
+                ret.merge(*it);
+            }
+            return ret;
+        }
+
+        Sketch_t combine(const Sketch_t& lhs, const Sketch_t& rhs) override {
+            Sketch_t ret = lhs;
+            return ret.merge(rhs);
+        }
+
+        void accumulate(Sketch_t& partial, Element_t& element) override {
+            partial.insert(key(element));
+        }
+
+    private:
+
+        size_t capacity;
+};
+
+#include "Sketch.tpp"
+
+} // namespace abstract
+
+#endif // #ifndef ABSTRACT_SKETCH_H
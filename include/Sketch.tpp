@@ -0,0 +1,329 @@
+
+//
+
+inline HyperLogLog::HyperLogLog(int precision)
+    : precision(precision), registers()
+{
+    if (precision < 4 || precision > 18) {
+        std::cerr << "HyperLogLog::HyperLogLog(): error: precision must lie in [4, 18]";
+        std::exit(EXIT_FAILURE);
+    }
+    registers.assign(size_t(1) << precision, 0);
+}
+
+inline void HyperLogLog::insert_hash(uint64_t hash) {
+    // the top bits select the register, the position of the first
+    // set bit among the rest is the observed rank; the guard bit
+    // bounds the rank for the all-zero tail
+    size_t index = hash >> (64-precision);
+    uint64_t rest = (hash << precision) | (uint64_t(1) << (precision-1));
+    uint8_t rank = __builtin_clzll(rest)+1;
+    if (rank > registers[index]) {
+        registers[index] = rank;
+    }
+}
+
+inline HyperLogLog& HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision) {
+        std::cerr << "HyperLogLog::merge(): error: cannot merge sketches of different precision";
+        std::exit(EXIT_FAILURE);
+    }
+    for (size_t i=0; i<registers.size(); i++) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+    return *this;
+}
+
+inline double HyperLogLog::estimate() const {
+    double m = registers.size();
+    double alpha = 0.7213/(1.0+1.079/m);
+
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i=0; i<registers.size(); i++) {
+        sum += std::ldexp(1.0, -registers[i]);
+        zeros += (registers[i] == 0) ? 1 : 0;
+    }
+
+    double ret = alpha*m*m/sum;
+
+    // small range correction: linear counting
+    if (ret <= 2.5*m && zeros > 0) {
+        ret = m*std::log(m/zeros);
+    }
+
+    return ret;
+}
+
+template <typename ValueType>
+KLLSketch<ValueType>::KLLSketch(int k)
+    : k(k), n(0), coin(0x9e3779b97f4a7c15ULL), levels(1)
+{
+    if (k < 8) {
+        std::cerr << "KLLSketch::KLLSketch(): error: k must be at least 8";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template <typename ValueType>
+size_t KLLSketch<ValueType>::capacity(size_t level) const {
+    // capacities shrink by 2/3 from the top level down
+    size_t depth = levels.size()-1-level;
+    size_t ret = std::ceil(k*std::pow(2.0/3.0, depth));
+    return (ret < 2) ? 2 : ret;
+}
+
+template <typename ValueType>
+void KLLSketch<ValueType>::insert(const ValueType& value) {
+    levels[0].push_back(value);
+    n++;
+    if (levels[0].size() >= capacity(0)) {
+        compress();
+    }
+}
+
+template <typename ValueType>
+void KLLSketch<ValueType>::compress() {
+    for (size_t h=0; h<levels.size(); h++) {
+        if (levels[h].size() >= capacity(h)) {
+            compact(h);
+        }
+    }
+}
+
+template <typename ValueType>
+void KLLSketch<ValueType>::compact(size_t level) {
+
+    if (level+1 == levels.size()) {
+        levels.emplace_back();
+    }
+
+    std::vector<ValueType>& items = levels[level];
+    std::vector<ValueType>& upper = levels[level+1];
+
+    std::sort(items.begin(), items.end());
+
+    // xorshift coin picks the odd or even items to promote
+    coin ^= coin << 13;
+    coin ^= coin >> 7;
+    coin ^= coin << 17;
+    size_t offset = coin & 1;
+
+    // an odd item out stays at its level
+    size_t even = items.size() & ~size_t(1);
+    for (size_t i=offset; i<even; i+=2) {
+        upper.push_back(items[i]);
+    }
+    items.erase(items.begin(), items.begin()+even);
+}
+
+template <typename ValueType>
+KLLSketch<ValueType>& KLLSketch<ValueType>::merge(const KLLSketch<ValueType>& other) {
+
+    if (other.levels.size() > levels.size()) {
+        levels.resize(other.levels.size());
+    }
+
+    for (size_t h=0; h<other.levels.size(); h++) {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+    }
+    n += other.n;
+
+    compress();
+    return *this;
+}
+
+template <typename ValueType>
+double KLLSketch<ValueType>::rank(const ValueType& value) const {
+
+    if (n == 0) {
+        return 0.0;
+    }
+
+    uint64_t weight = 0;
+    for (size_t h=0; h<levels.size(); h++) {
+        for (const ValueType& item : levels[h]) {
+            if (!(value < item)) {
+                weight += uint64_t(1) << h;
+            }
+        }
+    }
+
+    return double(weight)/n;
+}
+
+template <typename ValueType>
+ValueType KLLSketch<ValueType>::quantile(double q) const {
+
+    if (n == 0) {
+        std::cerr << "KLLSketch::quantile(): error: cannot query an empty sketch";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // items with their weights in sorted order
+    std::vector<std::pair<ValueType,uint64_t>> weighted;
+    for (size_t h=0; h<levels.size(); h++) {
+        for (const ValueType& item : levels[h]) {
+            weighted.emplace_back(item, uint64_t(1) << h);
+        }
+    }
+    std::sort(weighted.begin(), weighted.end(),
+              [](const std::pair<ValueType,uint64_t>& a, const std::pair<ValueType,uint64_t>& b) {
+                  return a.first < b.first;
+              });
+
+    double target = q*n;
+    uint64_t cumulative = 0;
+    for (size_t i=0; i<weighted.size(); i++) {
+        cumulative += weighted[i].second;
+        if (cumulative >= target) {
+            return weighted[i].first;
+        }
+    }
+
+    return weighted.back().first;
+}
+
+template <typename KeyType>
+SpaceSaving<KeyType>::SpaceSaving(size_t capacity)
+    : capacity(capacity), total(0), heap(), positions()
+{
+    if (capacity == 0) {
+        std::cerr << "SpaceSaving::SpaceSaving(): error: capacity cannot be zero";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template <typename KeyType>
+uint64_t SpaceSaving<KeyType>::min_count() const {
+    return (heap.size() < capacity) ? 0 : heap[0].count;
+}
+
+template <typename KeyType>
+void SpaceSaving<KeyType>::insert(const KeyType& key, uint64_t count) {
+
+    total += count;
+
+    auto it = positions.find(key);
+    if (it != positions.end()) {
+        size_t i = it->second;
+        heap[i].count += count;
+        sift_down(i);
+    } else if (heap.size() < capacity) {
+        heap.push_back(Counter{key, count, 0});
+        positions[key] = heap.size()-1;
+        sift_up(heap.size()-1);
+    } else {
+        // replace the smallest counter
+        uint64_t min = heap[0].count;
+        positions.erase(heap[0].key);
+        heap[0] = Counter{key, min+count, min};
+        positions[key] = 0;
+        sift_down(0);
+    }
+}
+
+template <typename KeyType>
+SpaceSaving<KeyType>& SpaceSaving<KeyType>::merge(const SpaceSaving<KeyType>& other) {
+
+    // keys missing from a full summary might have had
+    // up to its smallest count there
+    uint64_t min = min_count();
+    uint64_t other_min = other.min_count();
+
+    std::vector<Counter> merged;
+    merged.reserve(heap.size()+other.heap.size());
+
+    for (const Counter& c : heap) {
+        auto it = other.positions.find(c.key);
+        if (it != other.positions.end()) {
+            const Counter& oc = other.heap[it->second];
+            merged.push_back(Counter{c.key, c.count+oc.count, c.error+oc.error});
+        } else {
+            merged.push_back(Counter{c.key, c.count+other_min, c.error+other_min});
+        }
+    }
+    for (const Counter& oc : other.heap) {
+        if (positions.find(oc.key) == positions.end()) {
+            merged.push_back(Counter{oc.key, oc.count+min, oc.error+min});
+        }
+    }
+
+    // keep the largest counters
+    if (merged.size() > capacity) {
+        std::nth_element(merged.begin(), merged.begin()+capacity, merged.end(),
+                         [](const Counter& a, const Counter& b) { return a.count > b.count; });
+        merged.resize(capacity);
+    }
+
+    heap = std::move(merged);
+    positions.clear();
+    for (size_t i=0; i<heap.size(); i++) {
+        positions[heap[i].key] = i;
+    }
+    for (size_t i=heap.size()/2; i-- > 0; ) {
+        sift_down(i);
+    }
+
+    total += other.total;
+    return *this;
+}
+
+template <typename KeyType>
+std::vector<typename SpaceSaving<KeyType>::Counter> SpaceSaving<KeyType>::top(size_t k) const {
+    std::vector<Counter> ret(heap);
+    std::sort(ret.begin(), ret.end(),
+              [](const Counter& a, const Counter& b) { return a.count > b.count; });
+    if (ret.size() > k) {
+        ret.resize(k);
+    }
+    return ret;
+}
+
+template <typename KeyType>
+uint64_t SpaceSaving<KeyType>::estimate(const KeyType& key) const {
+    auto it = positions.find(key);
+    return (it != positions.end()) ? heap[it->second].count : 0;
+}
+
+template <typename KeyType>
+void SpaceSaving<KeyType>::swap_counters(size_t i, size_t j) {
+    std::swap(heap[i], heap[j]);
+    positions[heap[i].key] = i;
+    positions[heap[j].key] = j;
+}
+
+template <typename KeyType>
+void SpaceSaving<KeyType>::sift_up(size_t i) {
+    while (i > 0) {
+        size_t parent = (i-1)/2;
+        if (heap[parent].count <= heap[i].count) {
+            break;
+        }
+        swap_counters(i, parent);
+        i = parent;
+    }
+}
+
+template <typename KeyType>
+void SpaceSaving<KeyType>::sift_down(size_t i) {
+    size_t size = heap.size();
+    while (true) {
+        size_t smallest = i;
+        size_t left = 2*i+1;
+        size_t right = 2*i+2;
+        if (left < size && heap[left].count < heap[smallest].count) {
+            smallest = left;
+        }
+        if (right < size && heap[right].count < heap[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            break;
+        }
+        swap_counters(i, smallest);
+        i = smallest;
+    }
+}
+
+// end
@@ -0,0 +1,159 @@
+//
+// compares the distributed skeletons with their single-process
+// results; run with mpirun -np N for any N
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Fractal_dynamic.h"
+#include "Reduce.h"
+#include "Distributed.h"
+
+using namespace abstract;
+
+struct Node;
+using NodeFractal = Fractal<Node,uint64_t,3>;
+
+struct Node : NodeFractal::Element {
+    uint64_t value;
+    Node(const NodeFractal::ElementInfo& info) : NodeFractal::Element(info), value(0) {}
+    void grow(uint64_t seed) override {
+        value = seed*3+element_info().level*7+element_info().index;
+    }
+    uint64_t spawn_child_seed(int child_id) override {
+        return get_seed()*5+child_id+value%3;
+    }
+};
+
+// order-sensitive hash of the subtree
+struct TreeHash : NodeFractal::ComputeFunction<uint64_t> {
+    uint64_t operator()(Node& node, const std::vector<uint64_t>& child_rets) override {
+        uint64_t ret = node.value;
+        for (uint64_t r : child_rets) {
+            ret = ret*31+r;
+        }
+        return ret;
+    }
+};
+
+// the layout of the subtree as text
+struct TreeText : NodeFractal::ComputeFunction<std::string> {
+    std::string operator()(Node& node, const std::vector<std::string>& child_rets) override {
+        std::string ret = "(" + std::to_string(node.element_info().index);
+        for (const std::string& r : child_rets) {
+            ret += r;
+        }
+        return ret + ")";
+    }
+};
+
+// whether some value of the subtree is divisible by 1000
+struct TreeAny : NodeFractal::ComputeFunction<bool> {
+    bool operator()(Node& node, const std::vector<bool>& child_rets) override {
+        bool ret = (node.value % 1000 == 0);
+        for (bool r : child_rets) {
+            ret = ret || r;
+        }
+        return ret;
+    }
+};
+
+struct Item;
+using ItemReduce = Reduce<Item,int,int>;
+
+struct Item : ItemReduce::Element {
+    int value;
+    Item(const ItemReduce::ElementInfo& info) : ItemReduce::Element(info), value(info.index) {}
+};
+
+// the digits of the elements in order
+struct Digits : ItemReduce::ComputeFunction<std::string> {
+    using ItemReduce::ComputeFunction<std::string>::operator();
+    std::string operator()(Item& item) override {
+        return std::to_string(item.value % 10);
+    }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "distributed_test: FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+static void test_fractal(int rank) {
+    for (int depth : {0, 1, 2, 5, 8}) {
+        for (bool parallel : {false, true}) {
+            std::string name = "depth " + std::to_string(depth) + (parallel ? " parallel" : " sequential");
+
+            NodeFractal local;
+            local.set_type(NodeFractal::Type::balanced);
+            local.grow(depth, 11);
+
+            NodeFractal fractal;
+            fractal.set_type(NodeFractal::Type::balanced);
+            if (parallel) {
+                fractal.set_impl_type(NodeFractal::ImplType::parallel);
+            }
+
+            DistributedFractal<NodeFractal> distributed(fractal);
+            distributed.grow(depth, 11);
+
+            TreeHash hash;
+            TreeText text;
+            TreeAny any;
+
+            // broadcast results on all the ranks, others on rank 0
+            check(distributed.compute(hash, true) == local.compute(hash), "fractal hash, " + name);
+
+            std::string distributed_text = distributed.compute(text);
+            bool distributed_any = distributed.compute(any);
+            if (rank == 0) {
+                check(distributed_text == local.compute(text), "fractal text, " + name);
+                check(distributed_any == local.compute(any), "fractal bool, " + name);
+            }
+        }
+    }
+}
+
+static void test_reduce() {
+    for (size_t width : {0, 1, 2, 3, 7, 100, 1001}) {
+        ItemReduce reduce;
+        reduce.set_combine_type(ItemReduce::CombineType::associative);
+
+        DistributedReduce<ItemReduce> distributed(reduce);
+        distributed.grow(width);
+
+        Digits digits;
+        std::string expected;
+        for (size_t i = 0; i < width; i++) {
+            expected += std::to_string(i % 10);
+        }
+
+        check(distributed.compute(digits, true) == expected, "reduce width " + std::to_string(width));
+    }
+}
+
+int main(int argc, char** argv) {
+
+    MPI_Init(&argc, &argv);
+
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    test_fractal(rank);
+    test_reduce();
+
+    int all_failures = 0;
+    MPI_Allreduce(&failures, &all_failures, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+
+    return (all_failures > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,256 @@
+//
+// checks the CSR graph kernels against simple sequential
+// references, and the edge list loaders against each other
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <queue>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "Graph.h"
+
+using namespace abstract;
+
+using IntGraph = Graph<int,int>;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "graph_test: FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+// deterministic pseudo-random stream
+static uint64_t next_random(uint64_t& state) {
+    state = state*6364136223846793005ULL+1442695040888963407ULL;
+    return state >> 33;
+}
+
+static std::vector<int> reference_bfs(const IntGraph& graph, int source) {
+    std::vector<int> depth(graph.node_size(), -1);
+    std::queue<int> queue;
+    depth[source] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+        int u = queue.front();
+        queue.pop();
+        for (int v : graph.out_neighbors(u)) {
+            if (depth[v] < 0) {
+                depth[v] = depth[u]+1;
+                queue.push(v);
+            }
+        }
+    }
+    return depth;
+}
+
+static int find_root(std::vector<int>& parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+// the smallest node index of every component, by union-find
+static std::vector<int> reference_components(const IntGraph& graph) {
+    int n = graph.node_size();
+    std::vector<int> parent(n);
+    for (int v=0; v<n; v++) {
+        parent[v] = v;
+    }
+    for (int u=0; u<n; u++) {
+        for (int v : graph.out_neighbors(u)) {
+            int ru = find_root(parent, u);
+            int rv = find_root(parent, v);
+            if (ru != rv) {
+                parent[std::max(ru, rv)] = std::min(ru, rv);
+            }
+        }
+    }
+    std::vector<int> comp(n);
+    for (int v=0; v<n; v++) {
+        comp[v] = find_root(parent, v);
+    }
+    return comp;
+}
+
+static void write_text(const std::string& path, const std::string& text) {
+    std::ofstream out(path);
+    out << text;
+}
+
+static void test_edge_lists() {
+
+    std::string text_path = "graph_test.txt";
+    std::string binary_path = "graph_test.bin";
+
+    // duplicates of 0->1 and 2->0, the last one of each wins
+    write_text(text_path,
+               "# comment\n"
+               "0 1 10\n"
+               "% comment\n"
+               "2 0 20\n"
+               "\n"
+               "0 3 30\n"
+               "0 1 11\n"
+               "3 2 40\n"
+               "2 0 21");
+
+    IntGraph text_graph;
+    text_graph.load_edge_list(text_path);
+
+    check(text_graph.node_size() == 4, "load_edge_list() grows the node store to the largest index");
+    check(text_graph.edge_size() == 4, "load_edge_list() drops the duplicate edges");
+    check(text_graph.find_edge({0,1}) == 11 && text_graph.find_edge({2,0}) == 21, "the last one of the duplicate edges wins");
+    check(text_graph.find_edge({0,3}) == 30 && text_graph.find_edge({3,2}) == 40, "load_edge_list() reads the edge data");
+    check(text_graph.find_edge({1,0}) == IntGraph::invalid_edge, "find_edge() misses an absent edge");
+    check(text_graph.out_neighbors(0).size() == 2 && text_graph.out_neighbors(0)[0] == 1 && text_graph.out_neighbors(0)[1] == 3,
+          "the adjacency lists are sorted by target");
+    check(text_graph.in_degree(0) == 1 && text_graph.in_degree(2) == 1 && text_graph.in_degree(1) == 1,
+          "the incoming edges match the outgoing ones");
+
+    IntGraph unsorted_graph;
+    unsorted_graph.load_edge_list(text_path, IntGraph::EdgeListFormat::text, false);
+    check(unsorted_graph.edge_size() == 6, "without sort_and_dedup the duplicate edges are kept");
+
+    // the same edges as records
+    std::vector<IntGraph::EdgeRecord> records = {
+        {0, 1, 10}, {2, 0, 20}, {0, 3, 30}, {0, 1, 11}, {3, 2, 40}, {2, 0, 21}
+    };
+    {
+        std::ofstream out(binary_path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(records.data()), records.size()*sizeof(IntGraph::EdgeRecord));
+    }
+
+    IntGraph binary_graph;
+    binary_graph.load_edge_list(binary_path, IntGraph::EdgeListFormat::binary);
+
+    bool same = (binary_graph.node_size() == text_graph.node_size() && binary_graph.edge_size() == text_graph.edge_size());
+    for (int u=0; same && u<4; u++) {
+        same = (binary_graph.out_degree(u) == text_graph.out_degree(u));
+        for (std::size_t e=0; same && e<text_graph.out_degree(u); e++) {
+            same = (binary_graph.out_neighbors(u)[e] == text_graph.out_neighbors(u)[e] &&
+                    binary_graph.out_edges(u)[e] == text_graph.out_edges(u)[e]);
+        }
+    }
+    check(same, "the binary edge list loads the same graph as the text one");
+
+    // edges added after loading replace or extend the loaded ones
+    text_graph.add_edge({0,1}, 12);
+    text_graph.add_edge({1,4}, 50);
+    text_graph.build();
+
+    check(text_graph.node_size() == 5, "build() after load_edge_list() grows the node store");
+    check(text_graph.edge_size() == 5, "build() after load_edge_list() keeps the loaded edges");
+    check(text_graph.find_edge({0,1}) == 12, "build() after load_edge_list() replaces an existing edge");
+    check(text_graph.find_edge({1,4}) == 50 && text_graph.find_edge({3,2}) == 40, "build() after load_edge_list() merges the edges");
+    check(text_graph.in_degree(4) == 1 && text_graph.in_neighbors(1)[0] == 0, "build() rebuilds the incoming edges");
+
+    unlink(text_path.c_str());
+    unlink(binary_path.c_str());
+}
+
+static void test_bfs() {
+
+    // a star in both directions: the frontier of the center
+    // holds all the edges, which switches to bottom-up steps
+    const int n = 100000;
+    IntGraph star(n);
+    for (int v=1; v<n; v++) {
+        star.add_edge({0,v}, 1);
+        star.add_edge({v,0}, 1);
+    }
+    star.build();
+
+    check(star.bfs(0) == reference_bfs(star, 0), "bfs() of a star from its center");
+    check(star.bfs(n-1) == reference_bfs(star, n-1), "bfs() of a star from a leaf");
+
+    // a sparse random graph with a long tail switches back to
+    // top-down steps once the frontier shrinks
+    const int m = 20000;
+    uint64_t state = 42;
+    IntGraph graph(m);
+    for (int i=0; i<4*m; i++) {
+        int u = next_random(state) % (m/2);
+        int v = next_random(state) % (m/2);
+        graph.add_edge({u,v}, 1);
+    }
+    for (int v=m/2; v+1<m; v++) {
+        graph.add_edge({v,v+1}, 1);
+    }
+    graph.add_edge({0,m/2}, 1);
+    graph.build();
+
+    bool same = true;
+    for (int source : {0, 1, m/2, m-1}) {
+        same = same && (graph.bfs(source) == reference_bfs(graph, source));
+    }
+    check(same, "bfs() of a random graph matches the sequential search");
+}
+
+static void test_components_and_pagerank() {
+
+    const int n = 30000;
+    uint64_t state = 7;
+
+    // sparse enough to leave many components behind
+    IntGraph graph(n);
+    for (int i=0; i<n/2; i++) {
+        int u = next_random(state) % n;
+        int v = next_random(state) % n;
+        graph.add_edge({u,v}, 1);
+    }
+    graph.build();
+
+    check(graph.connected_components() == reference_components(graph), "connected_components() matches union-find");
+
+    std::vector<double> rank = graph.pagerank(0.85, 200, 1e-12);
+
+    double sum = 0.0;
+    for (double r : rank) {
+        sum += r;
+    }
+    check(std::fabs(sum-1.0) < 1e-9, "pagerank() sums to one with dangling nodes");
+
+    // a fixed point of the iteration
+    double dangling = 0.0;
+    for (int u=0; u<n; u++) {
+        if (graph.out_degree(u) == 0) {
+            dangling += rank[u];
+        }
+    }
+    double worst = 0.0;
+    for (int v=0; v<n; v++) {
+        double pulled = 0.0;
+        for (int u : graph.in_neighbors(v)) {
+            pulled += rank[u]/graph.out_degree(u);
+        }
+        double expected = (1.0-0.85)/n+0.85*(dangling/n+pulled);
+        worst = std::max(worst, std::fabs(expected-rank[v]));
+    }
+    check(worst < 1e-10, "pagerank() converges to the fixed point");
+}
+
+int main() {
+
+    test_edge_lists();
+    test_bfs();
+    test_components_and_pagerank();
+
+    if (failures > 0) {
+        std::cerr << "graph_test: " << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
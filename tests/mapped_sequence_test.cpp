@@ -0,0 +1,125 @@
+//
+// checks that a mapped sequence survives growing, shrinking
+// and reopening its file
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <iostream>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "MappedSequence.h"
+
+using namespace abstract;
+
+struct Point {
+    int64_t x;
+    double y;
+};
+
+using Points = MappedSequence<Point>;
+
+// the header preceding the elements in the file
+static const std::size_t header_bytes = 64;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "mapped_sequence_test: FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+static std::size_t file_size(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return 0;
+    }
+    return st.st_size;
+}
+
+static Point point(std::size_t i) {
+    return Point{ static_cast<int64_t>(i*i), 0.5*i };
+}
+
+static bool holds_points(Points& points, std::size_t n) {
+    if (points.size() != n) {
+        return false;
+    }
+    for (std::size_t i=0; i<n; i++) {
+        if (points[i].x != point(i).x || points[i].y != point(i).y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+
+    std::string path = "mapped_sequence_test.seq";
+    unlink(path.c_str());
+
+    const std::size_t n = 5000;
+
+    {
+        Points points(path);
+        check(points.empty(), "a new file holds an empty sequence");
+
+        // grows the file and the mapping a few times
+        for (std::size_t i=0; i<n; i++) {
+            points.add(point(i));
+        }
+        check(holds_points(points, n), "add() keeps the elements across growing");
+        check(points.capacity() >= n, "add() grows the capacity");
+        check(file_size(path) == header_bytes+points.capacity()*sizeof(Point), "the file holds the whole capacity");
+    }
+
+    {
+        // reopens the elements in place, capacity included
+        Points points(path);
+        check(holds_points(points, n), "reopening maps the elements back");
+        check(file_size(path) == header_bytes+points.capacity()*sizeof(Point), "reopening keeps the capacity of the file");
+
+        points.shrink_to_fit();
+        check(points.capacity() == n, "shrink_to_fit() drops the spare capacity");
+        check(file_size(path) == header_bytes+n*sizeof(Point), "shrink_to_fit() truncates the file");
+        check(holds_points(points, n), "shrink_to_fit() keeps the elements");
+        points.sync();
+    }
+
+    {
+        // a full sequence grows again on the next add()
+        Points points(path);
+        check(points.capacity() == n, "reopening a shrunk file keeps its capacity");
+        check(holds_points(points, n), "reopening a shrunk file maps the elements back");
+
+        points.add(point(n));
+        check(points.capacity() > n, "add() grows a full reopened sequence");
+        check(holds_points(points, n+1), "add() after reopening keeps the elements");
+
+        points.reserve(4*n);
+        check(points.capacity() == 4*n, "reserve() grows the capacity");
+        check(file_size(path) == header_bytes+4*n*sizeof(Point), "reserve() grows the file");
+
+        points.clear();
+        check(points.empty(), "clear() empties the sequence");
+    }
+
+    {
+        Points points(path);
+        check(points.empty() && points.capacity() == 4*n, "clear() is persistent and keeps the capacity");
+    }
+
+    unlink(path.c_str());
+
+    if (failures > 0) {
+        std::cerr << "mapped_sequence_test: " << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
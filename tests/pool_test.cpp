@@ -0,0 +1,227 @@
+//
+// checks the work-stealing pool: nested calls, exceptions,
+// spawned tasks and shutting down with queued work
+//
+
+#include <cstdlib>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <iostream>
+
+#include "Framework.h"
+#include "Reduce.h"
+
+using namespace abstract;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "pool_test: FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+struct Item;
+using ItemReduce = Reduce<Item,int,int>;
+
+struct Item : ItemReduce::Element {
+    long value;
+    Item(const ItemReduce::ElementInfo& info) : ItemReduce::Element(info), value(info.index) {}
+};
+
+struct Sum : ItemReduce::ComputeFunction<long> {
+    using ItemReduce::ComputeFunction<long>::operator();
+    long operator()(Item& item) override { return item.value; }
+    long combine(const long& a, const long& b) override { return a+b; }
+};
+
+struct Failing : Sum {
+    long operator()(Item& item) override {
+        if (item.value == 7) {
+            throw std::runtime_error("element");
+        }
+        return item.value;
+    }
+};
+
+static void test_nested(WorkStealingPool& pool) {
+
+    // every task of the invoke runs a parallel loop of its own
+    const std::size_t n = 10000;
+    std::vector<long> sums(8, 0);
+    std::vector<Executor::Task> tasks;
+    for (std::size_t t=0; t<sums.size(); t++) {
+        tasks.push_back([&pool, &sums, t, n]() {
+            std::atomic<long> sum(0);
+            pool.parallel_for(0, n, 16, [&sum, t](std::size_t begin, std::size_t end) {
+                long local = 0;
+                for (std::size_t i=begin; i<end; i++) {
+                    local += i*(t+1);
+                }
+                sum += local;
+            });
+            sums[t] = sum;
+        });
+    }
+    pool.invoke(tasks);
+
+    bool ok = true;
+    for (std::size_t t=0; t<sums.size(); t++) {
+        ok = ok && (sums[t] == static_cast<long>((t+1)*n*(n-1)/2));
+    }
+    check(ok, "parallel_for nested inside invoke covers every iteration");
+}
+
+static void test_exceptions(WorkStealingPool& pool) {
+
+    // many chunks throw, the call rethrows one of them once
+    int caught = 0;
+    bool other = false;
+    for (int round=0; round<50; round++) {
+        try {
+            pool.parallel_for(0, 64, 1, [round](std::size_t begin, std::size_t end) {
+                for (std::size_t i=begin; i<end; i++) {
+                    if ((i+round) % 3 == 0) {
+                        throw std::runtime_error("chunk");
+                    }
+                }
+            });
+        } catch (const std::runtime_error&) {
+            caught++;
+        } catch (...) {
+            other = true;
+        }
+    }
+    check(caught == 50 && !other, "a throwing parallel_for rethrows exactly once");
+
+    // an exception of a nested call reaches the outer caller once
+    caught = 0;
+    try {
+        pool.invoke({
+            []() {},
+            [&pool]() {
+                pool.parallel_for(0, 32, 1, [](std::size_t begin, std::size_t end) {
+                    if (begin <= 17 && 17 < end) {
+                        throw std::logic_error("nested");
+                    }
+                });
+            },
+            []() {}
+        });
+    } catch (const std::logic_error&) {
+        caught++;
+    }
+    check(caught == 1, "a nested exception is rethrown by the outer invoke once");
+
+    // the calling thread's own task throws
+    caught = 0;
+    try {
+        pool.invoke({ []() {}, []() { throw std::runtime_error("last"); } });
+    } catch (const std::runtime_error&) {
+        caught++;
+    }
+    check(caught == 1, "the caller's own task is rethrown once");
+
+    // the pool keeps working after the failed calls
+    std::atomic<long> sum(0);
+    pool.parallel_for(0, 1000, 1, [&sum](std::size_t begin, std::size_t end) {
+        for (std::size_t i=begin; i<end; i++) {
+            sum += i;
+        }
+    });
+    check(sum == 499500, "the pool runs calls after failed ones");
+}
+
+static void test_async(std::shared_ptr<WorkStealingPool> pool) {
+
+    // spawned tasks run to completion without being waited for
+    const int spawned = 1000;
+    std::atomic<int> done(0);
+    std::promise<void> all_done;
+    std::future<void> all_done_future = all_done.get_future();
+    for (int i=0; i<spawned; i++) {
+        pool->spawn([&done, &all_done, spawned]() {
+            if (done.fetch_add(1)+1 == spawned) {
+                all_done.set_value();
+            }
+        });
+    }
+    all_done_future.wait();
+    check(done == spawned, "spawn() runs every task");
+
+    // run_async() through the skeletons, on the pool and on the
+    // shared pool of the default executor
+    for (bool own_pool : {true, false}) {
+        ItemReduce reduce;
+        reduce.set_impl_type(ItemReduce::ImplType::parallel);
+        reduce.set_combine_type(ItemReduce::CombineType::associative);
+        if (own_pool) {
+            reduce.set_executor(pool);
+        }
+
+        Sum sum;
+        reduce.grow_async(10000).get();
+        std::future<long> ret = reduce.compute_async(sum);
+        check(ret.get() == 49995000, own_pool ? "compute_async() on the pool" : "compute_async() on the shared pool");
+    }
+
+    // an exception of an asynchronous call lands in its future
+    int caught = 0;
+    {
+        ItemReduce reduce;
+        reduce.set_impl_type(ItemReduce::ImplType::parallel);
+        reduce.set_combine_type(ItemReduce::CombineType::associative);
+        reduce.set_executor(pool);
+
+        Failing failing;
+        reduce.grow(1000);
+        std::future<long> ret = reduce.compute_async(failing);
+        try {
+            ret.get();
+        } catch (const std::runtime_error&) {
+            caught++;
+        }
+    }
+    check(caught == 1, "compute_async() reports an exception through its future");
+}
+
+static void test_shutdown() {
+
+    // the spawned tasks still queued are run before the workers stop
+    const int spawned = 2000;
+    std::atomic<int> done(0);
+    {
+        WorkStealingPool pool(2);
+        for (int i=0; i<spawned; i++) {
+            pool.spawn([&done]() {
+                volatile long x = 0;
+                for (int k=0; k<1000; k++) {
+                    x += k;
+                }
+                done++;
+            });
+        }
+    }
+    check(done == spawned, "destroying the pool drains the queued tasks");
+}
+
+int main() {
+
+    std::shared_ptr<WorkStealingPool> pool = std::make_shared<WorkStealingPool>(4);
+
+    test_nested(*pool);
+    test_exceptions(*pool);
+    test_async(pool);
+    test_shutdown();
+
+    if (failures > 0) {
+        std::cerr << "pool_test: " << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+//
+// checks the documented error bounds of the sketches
+// after reducing blocks of elements in separate thread
+// sketches and merging them
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+
+#include "Reduce.h"
+#include "Sketch.h"
+
+using namespace abstract;
+
+struct Record {
+    uint64_t value;
+};
+
+using RecordReduce = Reduce<Record,int,int>;
+
+struct Distinct : DistinctCountFunction<RecordReduce> {
+    Distinct(int precision) : DistinctCountFunction<RecordReduce>(precision) {}
+    uint64_t hash(Record& r) override { return sketch_hash(r.value); }
+};
+
+struct Quantiles : QuantileFunction<RecordReduce,uint64_t> {
+    uint64_t value(Record& r) override { return r.value; }
+};
+
+struct Heavy : TopKFunction<RecordReduce,uint64_t> {
+    Heavy(size_t capacity) : TopKFunction<RecordReduce,uint64_t>(capacity) {}
+    uint64_t key(Record& r) override { return r.value; }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "sketch_test: FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+// deterministic pseudo-random stream
+static uint64_t next_random(uint64_t& state) {
+    state += 0x9e3779b97f4a7c15ULL;
+    return sketch_mix(state);
+}
+
+// a reduction over the records with 8 thread sketches merged
+static void bind_records(RecordReduce& reduce, std::vector<Record>& records) {
+    reduce.set_impl_type(RecordReduce::ImplType::parallel);
+    reduce.set_combine_type(RecordReduce::CombineType::associative);
+    reduce.set_executor(std::make_shared<WorkStealingPool>(8));
+    reduce.bind(records.data(), records.size());
+}
+
+static void test_hyperloglog() {
+    for (int precision : {10, 12, 14}) {
+        double bound = 1.04/std::sqrt(double(1 << precision));
+        double squares = 0.0;
+        int trials = 0;
+
+        for (size_t distinct : {size_t(20000), size_t(100000), size_t(400000)}) {
+            for (uint64_t offset = 0; offset < 4; offset++) {
+                // every value appears twice
+                std::vector<Record> records;
+                for (size_t i = 0; i < 2*distinct; i++) {
+                    records.push_back(Record{offset*10000000+(i % distinct)});
+                }
+
+                RecordReduce reduce;
+                bind_records(reduce, records);
+                Distinct func(precision);
+                double error = reduce.compute(func).estimate()/distinct-1.0;
+
+                // single estimates within three standard errors
+                check(std::fabs(error) <= 3*bound, "HyperLogLog estimate within 3 standard errors");
+                squares += error*error;
+                trials++;
+            }
+        }
+
+        // the observed standard error matches the documented one
+        double observed = std::sqrt(squares/trials);
+        std::cout << "HyperLogLog p=" << precision << ": relative error " << observed
+                  << " (documented " << bound << ")" << std::endl;
+        check(observed <= 1.5*bound, "HyperLogLog relative standard error within 1.04/sqrt(2^p)");
+    }
+}
+
+static void test_kll() {
+    const size_t n = 1000000;
+
+    uint64_t state = 1;
+    std::vector<Record> records(n);
+    for (Record& r : records) {
+        r.value = next_random(state) % 100000000;
+    }
+
+    std::vector<uint64_t> sorted;
+    for (const Record& r : records) {
+        sorted.push_back(r.value);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    RecordReduce reduce;
+    bind_records(reduce, records);
+    Quantiles func;
+    KLLSketch<uint64_t> sketch = reduce.compute(func);
+
+    check(sketch.count() == n, "KLLSketch counts all the values");
+
+    // the documented bound for the default k = 400
+    double bound = 3.4/400;
+    double worst = 0.0;
+
+    for (int i = 1; i < 100; i++) {
+        double q = i/100.0;
+
+        uint64_t value = sketch.quantile(q);
+        double true_rank = double(std::upper_bound(sorted.begin(), sorted.end(), value)-sorted.begin())/n;
+        worst = std::max(worst, std::fabs(true_rank-q));
+
+        uint64_t exact = sorted[size_t(q*n)];
+        worst = std::max(worst, std::fabs(sketch.rank(exact)-double(size_t(q*n)+1)/n));
+    }
+
+    std::cout << "KLLSketch k=400: rank error " << worst << " (documented " << bound << ")" << std::endl;
+    check(worst <= bound, "KLLSketch rank error within 340/k percent after merging");
+}
+
+static void test_spacesaving() {
+    const size_t n = 1000000;
+    const size_t capacity = 200;
+
+    // a Zipf-like stream with a long tail of rare keys
+    uint64_t state = 7;
+    std::vector<Record> records(n);
+    std::unordered_map<uint64_t,uint64_t> counts;
+    for (Record& r : records) {
+        uint64_t x = next_random(state);
+        r.value = (x % 4 == 0) ? (x >> 8) % 1000000 : uint64_t(std::pow(2.0, double(x % 1000)/60.0)) % 5000;
+        counts[r.value]++;
+    }
+
+    // the thread sketches merged by the reduction
+    RecordReduce reduce;
+    bind_records(reduce, records);
+    Heavy func(capacity);
+    SpaceSaving<uint64_t> merged = reduce.compute(func);
+
+    // a merge of unequal summaries of disjoint blocks
+    SpaceSaving<uint64_t> first(capacity);
+    SpaceSaving<uint64_t> second(capacity);
+    for (size_t i = 0; i < n; i++) {
+        ((i < n/5) ? first : second).insert(records[i].value);
+    }
+    first.merge(second);
+
+    for (SpaceSaving<uint64_t>* sketch : {&merged, &first}) {
+        check(sketch->count() == n, "SpaceSaving counts all the values");
+
+        uint64_t bound = n/capacity;
+        uint64_t worst = 0;
+        bool underestimated = false;
+        bool missed = false;
+
+        for (const SpaceSaving<uint64_t>::Counter& c : sketch->top(capacity)) {
+            uint64_t true_count = counts[c.key];
+            underestimated |= (c.count < true_count);
+            worst = std::max(worst, c.count-std::min(c.count, true_count));
+        }
+        for (const auto& kv : counts) {
+            missed |= (kv.second > bound && sketch->estimate(kv.first) == 0);
+        }
+
+        std::cout << "SpaceSaving m=" << capacity << ": overestimate " << worst
+                  << " (documented N/m = " << bound << ")" << std::endl;
+        check(!underestimated, "SpaceSaving never underestimates a tracked key");
+        check(worst <= bound, "SpaceSaving overestimates by at most N/m after merging");
+        check(!missed, "SpaceSaving tracks every key above N/m after merging");
+    }
+}
+
+int main() {
+
+    test_hyperloglog();
+    test_kll();
+    test_spacesaving();
+
+    if (failures > 0) {
+        std::cerr << "sketch_test: " << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}